@@ -0,0 +1,146 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <nitrate-core/Allocate.hh>
+#include <nitrate-core/Assert.hh>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTFlat.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <sstream>
+#include <vector>
+
+using namespace ncc;
+using namespace ncc::lex;
+using namespace ncc::parse;
+
+template <typename T>
+struct Statistic {
+  T m_total;
+  T m_mean;
+  T m_variance;
+  T m_stddev;
+};
+
+template <typename T>
+static auto CalculateStatistic(const std::vector<T> &data) -> Statistic<T> {
+  T total = 0.0;
+  for (const auto &value : data) {
+    total += value;
+  }
+  T mean = total / data.size();
+
+  T variance = 0.0;
+  for (const auto &value : data) {
+    variance += std::pow(value - mean, 2);
+  }
+  variance /= data.size();
+
+  return {total, mean, variance, std::sqrt(variance)};
+}
+
+/* Materializes the tree in an arena, like the protobuf decoder */
+static void BenchDecode(const std::string &flat_ast) {
+  auto pool = DynamicArena();
+  if (!FlatAstReader(flat_ast, pool).Get().has_value()) {
+    qcore_panic("Failed to decode AST");
+  }
+}
+
+/* Visits every node in place, without building the tree */
+static size_t BenchTraverse(const std::string &flat_ast) {
+  auto ast = FlatAst::Open(flat_ast);
+  if (!ast.has_value()) {
+    qcore_panic("Failed to open flat AST");
+  }
+
+  size_t count = 0;
+  std::vector<FlatNode> stack = {ast->Root()};
+  while (!stack.empty()) {
+    auto node = stack.back();
+    stack.pop_back();
+    count++;
+
+    node.ForEachChild([&](FlatNode child) { stack.push_back(child); });
+  }
+
+  return count;
+}
+
+template <typename Fn>
+static void DoBenchmark(const char *name, Fn &&round) {
+  constexpr size_t kNumIterations = 128;
+
+  std::cout << "Starting benchmark..." << std::endl;
+  std::cout << "  Rounds: " << kNumIterations << std::endl;
+
+  std::vector<double> times;
+  for (size_t i = 0; i < kNumIterations; i++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    round();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    times.push_back(nanoseconds);
+  }
+
+  auto stats = CalculateStatistic(times);
+
+  std::cout << "Benchmark results:" << std::endl;
+  std::cout << "  Rounds: " << kNumIterations << std::endl;
+  std::cout << "  Mode: " << name << std::endl;
+  std::cout << "  Total time: " << stats.m_total << "ns" << std::endl;
+  std::cout << "  Round time mean: " << stats.m_mean << "ns" << std::endl;
+  std::cout << "  Round time variance: " << stats.m_variance << "ns" << std::endl;
+  std::cout << "  Round time standard deviation: " << stats.m_stddev << "ns" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv, argv + argc);
+
+  if (args.size() < 2) {
+    std::cerr << "Usage: " << args[0] << " <input-file>" << std::endl;
+    return 1;
+  }
+
+  const auto input_file = args[1];
+  std::ifstream input_stream(input_file);
+  if (!input_stream.is_open()) {
+    std::cerr << "Failed to open input file: " << input_file << std::endl;
+    return 1;
+  }
+
+  auto lib_rc = ParseLibrary.GetRC();
+  if (!lib_rc) {
+    std::cerr << "Failed to initialize the parser library" << std::endl;
+    return 1;
+  }
+
+  auto environment = std::make_shared<Environment>();
+  auto pool = DynamicArena();
+  auto scanner = Tokenizer(input_stream, environment);
+  auto parser = GeneralParser::Create(scanner, environment, pool)->Parse();
+  if (!parser.Check()) {
+    std::cerr << "Failed to parse input file: " << input_file << std::endl;
+    return 1;
+  }
+
+  std::string flat_ast;
+
+  {
+    std::stringstream ss;
+    FlatAstWriter(ss).Write(parser.Get());
+    flat_ast = ss.str();
+  }
+
+  std::cout << "Encoded size: " << flat_ast.size() << " bytes" << std::endl;
+  std::cout << "Node count: " << BenchTraverse(flat_ast) << std::endl;
+
+  DoBenchmark("decode", [&]() { BenchDecode(flat_ast); });
+  DoBenchmark("traverse", [&]() { BenchTraverse(flat_ast); });
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Init.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <sstream>
+
+using namespace ncc;
+using namespace ncc::lex;
+
+namespace no3::benchmark {
+  extern std::string LexicalBenchmarkSource;
+}
+
+template <typename T>
+struct Statistic {
+  T m_total;
+  T m_mean;
+  T m_variance;
+  T m_stddev;
+};
+
+template <typename T>
+static auto CalculateStatistic(const std::vector<T> &data) -> Statistic<T> {
+  T total = 0.0;
+  for (const auto &value : data) {
+    total += value;
+  }
+  T mean = total / data.size();
+
+  T variance = 0.0;
+  for (const auto &value : data) {
+    variance += std::pow(value - mean, 2);
+  }
+  variance /= data.size();
+
+  return {total, mean, variance, std::sqrt(variance)};
+}
+
+static size_t LexAll(Tokenizer &tokenizer) {
+  size_t tokens = 0;
+  while (tokenizer.Next()) {
+    tokens++;
+  }
+
+  return tokens;
+}
+
+static size_t BenchStream(const std::string &source) {
+  std::stringstream ss(source);
+  Tokenizer tokenizer(ss, std::make_shared<Environment>());
+
+  return LexAll(tokenizer);
+}
+
+static size_t BenchContiguous(const std::string &source) {
+  Tokenizer tokenizer(std::string_view(source), std::make_shared<Environment>());
+
+  return LexAll(tokenizer);
+}
+
+static void DoBenchmark(const char *name, size_t (*round)(const std::string &), const std::string &source) {
+  constexpr size_t kNumIterations = 128;
+  size_t tokens = 0;
+
+  std::vector<double> throughputs;
+  for (size_t i = 0; i < kNumIterations; i++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    tokens = round(source);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+
+    throughputs.push_back((source.size() / 1e6) / seconds);
+  }
+
+  auto stats = CalculateStatistic(throughputs);
+
+  std::cout << name << ":" << std::endl;
+  std::cout << "  Tokens per round: " << tokens << std::endl;
+  std::cout << "  Throughput mean: " << stats.m_mean << " MB/s" << std::endl;
+  std::cout << "  Throughput standard deviation: " << stats.m_stddev << " MB/s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv, argv + argc);
+
+  std::string source = no3::benchmark::LexicalBenchmarkSource;
+
+  if (args.size() >= 2) {
+    std::ifstream input_stream(args[1]);
+    if (!input_stream.is_open()) {
+      std::cerr << "Failed to open input file: " << args[1] << std::endl;
+      return 1;
+    }
+
+    source.assign(std::istreambuf_iterator<char>(input_stream), std::istreambuf_iterator<char>());
+  }
+
+  auto lib_rc = LexerLibrary.GetRC();
+  if (!lib_rc) {
+    std::cerr << "Failed to initialize the lexer library" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Input size: " << source.size() << " bytes" << std::endl;
+  std::cout << "Scan kernels: " << Tokenizer::GetScanKernelName() << std::endl;
+
+  DoBenchmark("Stream", BenchStream, source);
+  DoBenchmark("Contiguous", BenchContiguous, source);
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <nitrate-core/Allocate.hh>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+
+using namespace ncc;
+using namespace ncc::lex;
+using namespace ncc::parse;
+
+namespace no3::benchmark {
+  extern std::string LexicalBenchmarkSource;
+}
+
+template <typename T>
+struct Statistic {
+  T m_total;
+  T m_mean;
+  T m_variance;
+  T m_stddev;
+};
+
+template <typename T>
+static auto CalculateStatistic(const std::vector<T> &data) -> Statistic<T> {
+  T total = 0.0;
+  for (const auto &value : data) {
+    total += value;
+  }
+  T mean = total / data.size();
+
+  T variance = 0.0;
+  for (const auto &value : data) {
+    variance += std::pow(value - mean, 2);
+  }
+  variance /= data.size();
+
+  return {total, mean, variance, std::sqrt(variance)};
+}
+
+static auto ParseRound(const std::string &source) -> bool {
+  auto env = std::make_shared<Environment>();
+  auto pool = DynamicArena();
+  Tokenizer tokenizer(std::string_view(source), env);
+
+  return GeneralParser::Create(tokenizer, env, pool)->Parse().Check();
+}
+
+static void DoBenchmark(const std::string &source) {
+  constexpr size_t kNumIterations = 32;
+  bool success = true;
+
+  std::vector<double> throughputs;
+  for (size_t i = 0; i < kNumIterations; i++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    success = ParseRound(source) && success;
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+
+    throughputs.push_back((source.size() / 1e6) / seconds);
+  }
+
+  auto stats = CalculateStatistic(throughputs);
+
+  std::cout << "Parse:" << std::endl;
+  std::cout << "  Rounds: " << kNumIterations << std::endl;
+  std::cout << "  Syntax errors: " << (success ? "no" : "yes") << std::endl;
+  std::cout << "  Throughput mean: " << stats.m_mean << " MB/s" << std::endl;
+  std::cout << "  Throughput standard deviation: " << stats.m_stddev << " MB/s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv, argv + argc);
+
+  std::string source = no3::benchmark::LexicalBenchmarkSource;
+
+  if (args.size() >= 2) {
+    std::ifstream input_stream(args[1]);
+    if (!input_stream.is_open()) {
+      std::cerr << "Failed to open input file: " << args[1] << std::endl;
+      return 1;
+    }
+
+    source.assign(std::istreambuf_iterator<char>(input_stream), std::istreambuf_iterator<char>());
+  }
+
+  auto lib_rc = ParseLibrary.GetRC();
+  if (!lib_rc) {
+    std::cerr << "Failed to initialize the parser library" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Input size: " << source.size() << " bytes" << std::endl;
+
+  DoBenchmark(source);
+
+  return 0;
+}
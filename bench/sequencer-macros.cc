@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-seq/Init.hh>
+#include <nitrate-seq/Sequencer.hh>
+#include <sstream>
+
+using namespace ncc;
+using namespace ncc::lex;
+using namespace ncc::seq;
+
+template <typename T>
+struct Statistic {
+  T m_total;
+  T m_mean;
+  T m_variance;
+  T m_stddev;
+};
+
+template <typename T>
+static auto CalculateStatistic(const std::vector<T> &data) -> Statistic<T> {
+  T total = 0.0;
+  for (const auto &value : data) {
+    total += value;
+  }
+  T mean = total / data.size();
+
+  T variance = 0.0;
+  for (const auto &value : data) {
+    variance += std::pow(value - mean, 2);
+  }
+  variance /= data.size();
+
+  return {total, mean, variance, std::sqrt(variance)};
+}
+
+/* Every macro expansion is sequenced by its own child scanner, which runs
+ * into the end of its input once. */
+static std::string GenerateMacroDenseSource(size_t expansions) {
+  std::stringstream ss;
+
+  ss << "@(function twice(x) return x .. ' ' .. x end)\n";
+  for (size_t i = 0; i < expansions; i++) {
+    ss << "let v" << i << " = @(return twice('" << i << "'));\n";
+  }
+
+  return ss.str();
+}
+
+static size_t BenchSequence(const std::string &source) {
+  std::stringstream ss(source);
+  Sequencer sequencer(ss, std::make_shared<Environment>());
+
+  size_t tokens = 0;
+  while (sequencer.Next()) {
+    tokens++;
+  }
+
+  return tokens;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv, argv + argc);
+
+  size_t expansions = 10000;
+  if (args.size() >= 2) {
+    expansions = std::stoul(args[1]);
+  }
+
+  auto lib_rc = SeqLibrary.GetRC();
+  if (!lib_rc) {
+    std::cerr << "Failed to initialize the sequencer library" << std::endl;
+    return 1;
+  }
+
+  const auto source = GenerateMacroDenseSource(expansions);
+
+  constexpr size_t kNumIterations = 16;
+  size_t tokens = 0;
+
+  std::vector<double> rates;
+  for (size_t i = 0; i < kNumIterations; i++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    tokens = BenchSequence(source);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e9;
+
+    rates.push_back(expansions / seconds);
+  }
+
+  auto stats = CalculateStatistic(rates);
+
+  std::cout << "Benchmark results:" << std::endl;
+  std::cout << "  Rounds: " << kNumIterations << std::endl;
+  std::cout << "  Macro expansions per round: " << expansions << std::endl;
+  std::cout << "  Tokens per round: " << tokens << std::endl;
+  std::cout << "  Expansion rate mean: " << stats.m_mean << " /s" << std::endl;
+  std::cout << "  Expansion rate standard deviation: " << stats.m_stddev << " /s" << std::endl;
+
+  return 0;
+}
@@ -39,6 +39,7 @@
 #include <curlpp/cURLpp.hpp>
 #include <iostream>
 #include <memory>
+#include <nitrate-core/Cache.hh>
 #include <nitrate-core/Init.hh>
 #include <nitrate-core/Logger.hh>
 #include <nitrate-core/Macro.hh>
@@ -162,6 +163,12 @@ static bool PerformInitialize(std::ostream& log) {
     return false;
   }
 
+  /* Share cached artifacts (e.g. rendered imports) between compiler runs */
+  if (const char* cache_dir = std::getenv("NCC_CACHE_DIR");  // NOLINT(concurrency-mt-unsafe)
+      cache_dir != nullptr && *cache_dir != '\0') {
+    BindFileSystemCache(cache_dir);
+  }
+
   if (!lex::LexerLibrary.InitRC()) {
     log << "Failed to initialize libnitrate-lexer library" << std::endl;
     return false;
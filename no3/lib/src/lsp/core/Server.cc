@@ -6,6 +6,7 @@
 #include <memory>
 #include <mutex>
 #include <nitrate-core/Logger.hh>
+#include <nitrate-seq/Sequencer.hh>
 #include <shared_mutex>
 #include <stop_token>
 #include <utility>
@@ -187,6 +188,10 @@ void ServerContext::RegisterHandlers() {
 [[noreturn]] void ServerContext::StartServer(Connection& io) {
   RegisterHandlers();
 
+  /* The server handles many jobs, so let file system events invalidate
+   * resolved imports instead of listing the search path for every job */
+  ncc::seq::WatchResourceSearchPaths(true);
+
   m_thread_pool.Start();
   m_thread_pool.QueueJob([this](auto st) { RequestQueueLoop(st); });
 
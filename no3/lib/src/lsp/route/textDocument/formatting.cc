@@ -7,6 +7,7 @@
 #include <memory>
 #include <nitrate-core/Environment.hh>
 #include <nitrate-core/Logger.hh>
+#include <nitrate-core/String.hh>
 #include <nitrate-lexer/Scanner.hh>
 #include <nitrate-parser/AST.hh>
 #include <nitrate-parser/Context.hh>
@@ -104,8 +105,16 @@ void srv::DoFormatting(const RequestMessage& req, ResponseMessage& resp) {
 
   std::stringstream ss(*file->Content());
 
+  /* Everything interned while formatting is dropped with the request */
+  ncc::StringPool strings;
+  ncc::StringScope strings_scope(strings);
+
+  /* Formatting requests reuse Lua states that already ran the prelude */
+  static SequencerPool sequencers;
+
   auto env = std::make_shared<ncc::Environment>();
-  auto l = Sequencer(ss, env);
+  auto sequencer = sequencers.Create(ss, env);
+  auto &l = *sequencer;
   auto pool = ncc::DynamicArena();
   auto parser = ncc::parse::GeneralParser::Create(l, env, pool);
   auto ast = parser->Parse();
@@ -35,17 +35,44 @@
 #define __NITRATE_CORE_MEMORY_H__
 
 #include <cstddef>
+#include <cstdint>
 #include <memory_resource>
 #include <nitrate-core/AllocateFwd.hh>
 #include <nitrate-core/Macro.hh>
 
 namespace ncc {
+  enum class ArenaSync : uint8_t {
+    /* One bump region shared by all threads, guarded by SmartLock */
+    Shared,
+
+    /* Every thread bumps in a private region; allocation never locks */
+    PerThread,
+  };
+
+  struct ArenaPolicy {
+    /* Size of the first segment of every bump region */
+    size_t m_initial_segment = 1024 * 16;
+
+    /* Segments grow geometrically by this factor until they reach the cap */
+    size_t m_growth_factor = 1;
+    size_t m_max_segment = 1024 * 16;
+
+    /* Back segments with anonymous mmap() instead of operator new[] */
+    bool m_use_mmap = false;
+
+    /* Ask for transparent huge pages (MADV_HUGEPAGE); implies m_use_mmap */
+    bool m_huge_pages = false;
+
+    /* Bytes of segments kept for reuse across Reset() instead of freed */
+    size_t m_recycle_limit = 0;
+  };
+
   class NCC_EXPORT DynamicArena final : public IMemory {
     class PImpl;
     PImpl *m_pimpl;
 
   public:
-    DynamicArena();
+    DynamicArena(ArenaSync sync = ArenaSync::Shared, ArenaPolicy policy = {});
     DynamicArena(const DynamicArena &) = delete;
     DynamicArena(DynamicArena &&o) noexcept : m_pimpl(o.m_pimpl) { o.m_pimpl = nullptr; }
     ~DynamicArena() override;
@@ -61,6 +88,10 @@ namespace ncc {
     [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override;
     [[nodiscard]] auto GetSpaceUsed() const -> size_t;
     [[nodiscard]] auto GetSpaceManaged() const -> size_t;
+    [[nodiscard]] auto GetSync() const -> ArenaSync;
+    [[nodiscard]] auto GetPolicy() const -> const ArenaPolicy &;
+
+    /* Must not race with allocations from any thread */
     void Reset();
   };
 }  // namespace ncc
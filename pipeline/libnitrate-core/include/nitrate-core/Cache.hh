@@ -36,6 +36,7 @@
 
 #include <array>
 #include <cstdint>
+#include <filesystem>
 #include <functional>
 #include <mutex>
 #include <nitrate-core/Init.hh>
@@ -63,10 +64,7 @@ namespace ncc {
     using write_t = std::function<bool(const ResourceKey &, Value)>;
 
   public:
-    ExternalResourceCache()
-        : m_has([](const ResourceKey &) { return false; }),
-          m_read([](const ResourceKey &, Value &) { return false; }),
-          m_write([](const ResourceKey &, Value) { return false; }) {}
+    ExternalResourceCache() { Unbind(); }
 
     auto Has(const ResourceKey &key) -> bool override {
       SmartLock lock(m_mutex);
@@ -92,12 +90,31 @@ namespace ncc {
       m_has = std::move(has);
       m_read = std::move(read);
       m_write = std::move(write);
+      m_bound = true;
+    }
+
+    /** Restore the default backend, which never holds anything. */
+    void Unbind() {
+      SmartLock lock(m_mutex);
+
+      m_has = [](const ResourceKey &) { return false; };
+      m_read = [](const ResourceKey &, Value &) { return false; };
+      m_write = [](const ResourceKey &, Value) { return false; };
+      m_bound = false;
+    }
+
+    /** Whether a backend is bound. Callers can skip computing keys otherwise. */
+    [[nodiscard]] auto IsBound() -> bool {
+      SmartLock lock(m_mutex);
+
+      return m_bound;
     }
 
   private:
     has_t m_has;
     read_t m_read;
     write_t m_write;
+    bool m_bound = false;
     std::recursive_mutex m_mutex;
   };
 
@@ -109,9 +126,31 @@ namespace ncc {
     auto Write(const ResourceKey &, const Value &) -> bool override { return false; }
   };
 
+  /**
+   * On-disk backend that stores each value in its own file, named after the
+   * hexadecimal key and sharded by its first byte. Entries are written to a
+   * temporary file and renamed into place, so concurrent compiler processes
+   * sharing the directory never observe a partially written value.
+   */
+  class FileSystemResourceCache final : public IResourceCache<std::string> {
+    std::filesystem::path m_root;
+
+    [[nodiscard]] auto GetPath(const ResourceKey &key) const -> std::filesystem::path;
+
+  public:
+    FileSystemResourceCache(std::filesystem::path root) : m_root(std::move(root)) {}
+
+    auto Has(const ResourceKey &key) -> bool override;
+    auto Read(const ResourceKey &key, std::string &value) -> bool override;
+    auto Write(const ResourceKey &key, const std::string &value) -> bool override;
+  };
+
   using TheCache = ExternalResourceCache<std::string>;
 
   auto GetCache() -> TheCache &;
+
+  /** Route the global cache to a FileSystemResourceCache rooted at `root`. */
+  auto BindFileSystemCache(std::filesystem::path root) -> void;
 }  // namespace ncc
 
 #endif  // __NITRATE_CORE_CACHE_H__
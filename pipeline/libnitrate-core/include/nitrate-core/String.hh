@@ -44,14 +44,22 @@
 
 namespace ncc {
   class NCC_EXPORT __attribute__((packed)) String {
-    static std::string DefaultEmptyString;
+  public:
+    /* Every distinct string content has exactly one Storage instance */
+    struct Storage {
+      std::string m_data;
+      size_t m_hash = 0;
+    };
+
+  private:
+    static Storage DefaultEmptyString;
     friend struct CoreLibrarySetup;
 
-    const std::string *m_p;
+    const Storage *m_p;
 
     static void ResetInstances();
-    [[nodiscard, gnu::pure]] static auto CreateInstance(std::string_view str) -> const std::string &;
-    [[nodiscard, gnu::pure]] static auto CreateInstance(std::string &&str) -> const std::string &;
+    [[nodiscard, gnu::pure]] static auto CreateInstance(std::string_view str) -> const Storage &;
+    [[nodiscard, gnu::pure]] static auto CreateInstance(std::string &&str) -> const Storage &;
 
   public:
     constexpr explicit String() : m_p(&DefaultEmptyString) {}
@@ -66,9 +74,16 @@ namespace ncc {
     constexpr auto operator=(const String &str) -> String & = default;
     constexpr auto operator=(String &&str) noexcept -> String & = default;
 
-    [[nodiscard, gnu::pure]] constexpr auto Get() const -> const std::string & { return *m_p; };
-    [[nodiscard, gnu::pure]] constexpr auto operator==(const String &o) const -> bool { return Get() == o.Get(); }
-    [[nodiscard, gnu::pure]] constexpr auto operator!=(const String &o) const -> bool { return Get() != o.Get(); }
+    [[nodiscard, gnu::pure]] constexpr auto Get() const -> const std::string & { return m_p->m_data; };
+    [[nodiscard, gnu::pure]] constexpr auto Hash() const -> size_t { return m_p->m_hash; };
+
+    /* Interning deduplicates within a pool, so identity is the common case. The
+     * same content may live in different pools, which the hash settles cheaply. */
+    [[nodiscard, gnu::pure]] constexpr auto operator==(const String &o) const -> bool {
+      return m_p == o.m_p || (m_p->m_hash == o.m_p->m_hash && m_p->m_data == o.m_p->m_data);
+    }
+    [[nodiscard, gnu::pure]] constexpr auto operator!=(const String &o) const -> bool { return !(*this == o); }
+
     [[nodiscard, gnu::pure]] constexpr auto operator<(const String &o) const -> bool { return Get() < o.Get(); }
     [[nodiscard, gnu::pure]] constexpr auto operator<=(const String &o) const -> bool { return Get() <= o.Get(); }
     [[nodiscard, gnu::pure]] constexpr auto operator>(const String &o) const -> bool { return Get() > o.Get(); }
@@ -82,6 +97,39 @@ namespace ncc {
 
   static_assert(sizeof(String) == sizeof(uintptr_t));
 
+  /** An interning domain whose strings are all freed together, e.g. at the end of
+   * a compilation session. Strings from a pool must not outlive its Reset(). */
+  class NCC_EXPORT StringPool final {
+    friend class String;
+
+    class PImpl;
+    PImpl *m_pimpl;
+
+  public:
+    StringPool();
+    StringPool(const StringPool &) = delete;
+    ~StringPool();
+
+    /* Incremented by every Reset() */
+    [[nodiscard]] auto GetGeneration() const -> uint64_t;
+    [[nodiscard]] auto GetCount() const -> size_t;
+    void Reset();
+
+    /* The pool of the innermost StringScope on this thread, if any */
+    [[nodiscard]] static auto Current() -> StringPool *;
+  };
+
+  /** While alive, every String created on this thread is interned in the given
+   * pool instead of the process-global table. Scopes nest. */
+  class NCC_EXPORT StringScope final {
+    StringPool *m_previous;
+
+  public:
+    explicit StringScope(StringPool &pool);
+    StringScope(const StringScope &) = delete;
+    ~StringScope();
+  };
+
   using string = String;
 
   static inline auto operator<<(std::ostream &os, const String &str) -> std::ostream & { return os << str.Get(); }
@@ -90,9 +138,7 @@ namespace ncc {
 namespace std {
   template <>
   struct hash<ncc::String> {
-    [[nodiscard, gnu::const]] constexpr auto operator()(const ncc::String &str) const -> size_t {
-      return std::hash<std::string_view>{}(str);
-    }
+    [[nodiscard, gnu::const]] constexpr auto operator()(const ncc::String &str) const -> size_t { return str.Hash(); }
   };
 }  // namespace std
 
@@ -31,11 +31,91 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <memory>
 #include <nitrate-core/Cache.hh>
 #include <nitrate-core/Logger.hh>
 #include <nitrate-core/Macro.hh>
+#include <sstream>
 
 NCC_EXPORT auto ncc::GetCache() -> ncc::TheCache& {
   static TheCache cache;
   return cache;
 }
+
+auto ncc::FileSystemResourceCache::GetPath(const ResourceKey& key) const -> std::filesystem::path {
+  static constexpr std::string_view kHexDigits = "0123456789abcdef";
+
+  std::string name;
+  name.reserve(key.size() * 2);
+  for (auto byte : key) {
+    name += kHexDigits[byte >> 4];
+    name += kHexDigits[byte & 0xf];
+  }
+
+  return m_root / name.substr(0, 2) / name.substr(2);
+}
+
+NCC_EXPORT auto ncc::FileSystemResourceCache::Has(const ResourceKey& key) -> bool {
+  std::error_code ec;
+  return std::filesystem::is_regular_file(GetPath(key), ec);
+}
+
+NCC_EXPORT auto ncc::FileSystemResourceCache::Read(const ResourceKey& key, std::string& value) -> bool {
+  std::ifstream file(GetPath(key), std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  if (file.bad()) [[unlikely]] {
+    return false;
+  }
+
+  value = buffer.str();
+
+  return true;
+}
+
+NCC_EXPORT auto ncc::FileSystemResourceCache::Write(const ResourceKey& key, const std::string& value) -> bool {
+  static std::atomic<uint64_t> counter = 0;
+
+  const auto path = GetPath(key);
+
+  std::error_code ec;
+  std::filesystem::create_directories(path.parent_path(), ec);
+  if (ec) [[unlikely]] {
+    return false;
+  }
+
+  auto temp = path;
+  temp += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter++);
+
+  {
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    if (!file.write(value.data(), static_cast<std::streamsize>(value.size()))) [[unlikely]] {
+      std::filesystem::remove(temp, ec);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temp, path, ec);
+  if (ec) [[unlikely]] {
+    std::filesystem::remove(temp, ec);
+    return false;
+  }
+
+  return true;
+}
+
+NCC_EXPORT auto ncc::BindFileSystemCache(std::filesystem::path root) -> void {
+  auto backend = std::make_shared<FileSystemResourceCache>(std::move(root));
+
+  GetCache().Bind([backend](const ResourceKey& key) { return backend->Has(key); },
+                  [backend](const ResourceKey& key, std::string& value) { return backend->Read(key, value); },
+                  [backend](const ResourceKey& key, const std::string& value) { return backend->Write(key, value); });
+}
@@ -31,6 +31,8 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <nitrate-core/Assert.hh>
 #include <nitrate-core/SmartLock.hh>
@@ -74,75 +76,125 @@ public:
   }
 };
 
-static std::mutex StringLock;
-static NonLinearContainer<std::string, 1024> Strings;
+/* Shards are selected by the upper bits of the hash, leaving the lower bits for
+ * the bucket index inside each shard's table. */
+static constexpr size_t kShardCount = 32;
+static constexpr size_t kShardSelectShift = 48;
 
-#if MEMORY_OVER_SPEED == 1
-static google::dense_hash_map<std::string_view, const std::string*> FastMap = [] {
-  google::dense_hash_map<std::string_view, const std::string*> map;
-  map.set_empty_key("");
-  return map;
-}();
-#endif
+struct PrehashedKey {
+  std::string_view m_view;
+  size_t m_hash = 0;
+};
 
-std::string ncc::string::DefaultEmptyString;
+struct PrehashedKeyHash {
+  auto operator()(const PrehashedKey& key) const -> size_t { return key.m_hash; }
+};
 
-auto String::CreateInstance(std::string_view str) -> const std::string& {
-  if (str.empty()) {
-    return DefaultEmptyString;
+struct PrehashedKeyEqual {
+  auto operator()(const PrehashedKey& a, const PrehashedKey& b) const -> bool {
+    return a.m_hash == b.m_hash && a.m_view == b.m_view;
+  }
+};
+
+class alignas(64) StringShard final {
+  std::mutex m_mutex;
+  NonLinearContainer<String::Storage, 256> m_strings;
+  google::dense_hash_map<PrehashedKey, const String::Storage*, PrehashedKeyHash, PrehashedKeyEqual> m_map;
+
+public:
+  StringShard() { m_map.set_empty_key({}); }
+
+  template <typename StringType>
+  auto Intern(StringType&& str, size_t hash) -> const String::Storage& {
+    SmartLock lock(m_mutex);
+
+    /* Search for existing key, thereby deduplicating elements */
+    if (auto it = m_map.find({std::string_view(str), hash}); it != m_map.end()) {
+      return *it->second;
+    }
+
+    const auto* ptr = &m_strings.Append({std::string(std::forward<StringType>(str)), hash});
+    m_map[{std::string_view(ptr->m_data), hash}] = ptr;
+
+    qcore_assert(ptr != nullptr);
+
+    return *ptr;
+  }
+
+  void Clear() {
+    SmartLock lock(m_mutex);
+
+    m_map.clear();
+    m_strings.Clear();
   }
 
-  SmartLock lock(StringLock);
+  auto Size() -> size_t {
+    SmartLock lock(m_mutex);
 
-#if MEMORY_OVER_SPEED == 1
-  /* Search for existing key, thereby deduplicating elements */
-  if (auto it = FastMap.find(str); it != FastMap.end()) {
-    return *it->second;
+    return m_map.size();
   }
-#endif
+};
 
-  const std::string* ptr = &Strings.Append(std::string(str));
+class ncc::StringPool::PImpl final {
+public:
+  StringShard m_shard;
+  std::atomic<uint64_t> m_generation = 0;
+};
 
-#if MEMORY_OVER_SPEED == 1
-  FastMap[std::string_view(*ptr)] = ptr;
-#endif
+static thread_local StringPool* CurrentPool = nullptr;
 
-  qcore_assert(ptr != nullptr);
+static std::array<StringShard, kShardCount> Shards;
 
-  return *ptr;
+String::Storage ncc::string::DefaultEmptyString = {"", std::hash<std::string_view>{}("")};
+
+static NCC_FORCE_INLINE auto GetShard(size_t hash) -> StringShard& {
+  return Shards[(hash >> kShardSelectShift) % kShardCount];
 }
 
-auto String::CreateInstance(std::string&& str) -> const std::string& {
+auto String::CreateInstance(std::string_view str) -> const Storage& {
   if (str.empty()) {
     return DefaultEmptyString;
   }
 
-  SmartLock lock(StringLock);
+  const auto hash = std::hash<std::string_view>{}(str);
 
-#if MEMORY_OVER_SPEED == 1
-  /* Search for existing key, thereby deduplicating elements */
-  if (auto it = FastMap.find(str); it != FastMap.end()) {
-    return *it->second;
+  if (CurrentPool != nullptr) {
+    return CurrentPool->m_pimpl->m_shard.Intern(str, hash);
   }
-#endif
 
-  const std::string* ptr = &Strings.Append(std::move(str));
+  return GetShard(hash).Intern(str, hash);
+}
+
+auto String::CreateInstance(std::string&& str) -> const Storage& {
+  if (str.empty()) {
+    return DefaultEmptyString;
+  }
 
-#if MEMORY_OVER_SPEED == 1
-  FastMap[std::string_view(*ptr)] = ptr;
-#endif
+  const auto hash = std::hash<std::string_view>{}(str);
 
-  qcore_assert(ptr != nullptr);
+  if (CurrentPool != nullptr) {
+    return CurrentPool->m_pimpl->m_shard.Intern(std::move(str), hash);
+  }
 
-  return *ptr;
+  return GetShard(hash).Intern(std::move(str), hash);
 }
 
 void String::ResetInstances() {
-  SmartLock lock(StringLock);
+  for (auto& shard : Shards) {
+    shard.Clear();
+  }
+}
 
-  Strings.Clear();
+StringPool::StringPool() { m_pimpl = new PImpl(); }
+StringPool::~StringPool() { delete m_pimpl; }
+auto StringPool::GetGeneration() const -> uint64_t { return m_pimpl->m_generation.load(std::memory_order_relaxed); }
+auto StringPool::GetCount() const -> size_t { return m_pimpl->m_shard.Size(); }
+auto StringPool::Current() -> StringPool* { return CurrentPool; }
 
-#if MEMORY_OVER_SPEED == 1
-  FastMap.clear();
-#endif
+void StringPool::Reset() {
+  m_pimpl->m_shard.Clear();
+  m_pimpl->m_generation.fetch_add(1, std::memory_order_relaxed);
 }
+
+StringScope::StringScope(StringPool& pool) : m_previous(CurrentPool) { CurrentPool = &pool; }
+StringScope::~StringScope() { CurrentPool = m_previous; }
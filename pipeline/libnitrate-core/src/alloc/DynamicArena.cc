@@ -31,46 +31,202 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <mutex>
 #include <nitrate-core/Allocate.hh>
 #include <nitrate-core/Assert.hh>
 #include <nitrate-core/Macro.hh>
 #include <nitrate-core/SmartLock.hh>
+#include <optional>
+#include <thread>
 #include <vector>
 
 using namespace ncc;
 
-static constexpr size_t kPrimarySegmentSize = 1024 * 16;
+static constexpr size_t kThreadCacheWays = 8;
+static constexpr size_t kHugePageSize = 1024 * 1024 * 2;
 
 static NCC_FORCE_INLINE auto ALIGNED(uint8_t *ptr, size_t align) -> uint8_t * {
   size_t mod = reinterpret_cast<uintptr_t>(ptr) % align;
   return mod == 0 ? ptr : (ptr + (align - mod));
 }
 
+static NCC_FORCE_INLINE auto RoundUp(size_t size, size_t multiple) -> size_t {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
 struct Segment {
   uint8_t *m_base = nullptr, *m_offset = nullptr;
   size_t m_size = 0;
+  bool m_mapped = false;
 };
 
-class ncc::DynamicArena::PImpl final {
-  std::vector<Segment> m_bases;
-  mutable std::mutex m_mutex;
+/** Obtains segment memory from the system and keeps released segments around
+ * for reuse, up to the recycle limit of the policy. Thread-safe. */
+class SegmentSource final {
+  ArenaPolicy m_policy;
+  std::vector<Segment> m_recycled;
+  std::atomic<size_t> m_recycled_size = 0;
+  std::mutex m_mutex;
+
+  /* Actual number of bytes handed out for a request of the given size */
+  [[nodiscard]] auto GranularSize(size_t size) const -> size_t {
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+
+    if (!m_policy.m_use_mmap) {
+      return size;
+    }
+
+    return RoundUp(size, m_policy.m_huge_pages ? kHugePageSize : page_size);
+  }
+
+  [[nodiscard]] auto MapSegment(size_t size) const -> Segment {
+    size = GranularSize(size);
+
+    auto *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) [[unlikely]] {
+      return {};
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (m_policy.m_huge_pages) {
+      /* Advisory only; the kernel may not have THP enabled */
+      (void)madvise(base, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    auto *ptr = static_cast<uint8_t *>(base);
+    return {ptr, ptr, size, true};
+  }
+
+  static void FreeSegment(const Segment &seg) {
+    if (seg.m_mapped) {
+      munmap(seg.m_base, seg.m_size);
+    } else {
+      delete[] seg.m_base;
+    }
+  }
+
+public:
+  SegmentSource(ArenaPolicy policy) : m_policy(policy) {
+    if (m_policy.m_huge_pages) {
+      m_policy.m_use_mmap = true;
+    }
+
+    m_policy.m_initial_segment = std::max<size_t>(m_policy.m_initial_segment, 64);
+    m_policy.m_max_segment = std::max(m_policy.m_max_segment, m_policy.m_initial_segment);
+    m_policy.m_growth_factor = std::max<size_t>(m_policy.m_growth_factor, 1);
+  }
+
+  SegmentSource(const SegmentSource &) = delete;
+
+  ~SegmentSource() {
+    for (const auto &seg : m_recycled) {
+      FreeSegment(seg);
+    }
+  }
+
+  [[nodiscard]] auto GetPolicy() const -> const ArenaPolicy & { return m_policy; }
+  [[nodiscard]] auto GetRecycledSize() const -> size_t { return m_recycled_size.load(std::memory_order_relaxed); }
+
+  auto Acquire(size_t size) -> Segment {
+    if (m_recycled_size.load(std::memory_order_relaxed) != 0) {
+      std::lock_guard lock(m_mutex);
+
+      for (auto it = m_recycled.begin(); it != m_recycled.end(); ++it) {
+        if (it->m_size >= size) {
+          auto seg = *it;
+          m_recycled.erase(it);
+          m_recycled_size.fetch_sub(seg.m_size, std::memory_order_relaxed);
+
+          seg.m_offset = seg.m_base;
+          return seg;
+        }
+      }
+    }
+
+    if (m_policy.m_use_mmap) {
+      if (auto seg = MapSegment(size); seg.m_base != nullptr) [[likely]] {
+        return seg;
+      }
+    }
 
-  void AllocRegion(size_t size) {
     auto *base = new uint8_t[size];
-    m_bases.push_back({base, base, size});
+    return {base, base, size, false};
+  }
+
+  void Release(const Segment &seg) {
+    /* Oversized segments are one-off payloads; do not hoard them */
+    if (seg.m_size <= GranularSize(m_policy.m_max_segment)) {
+      std::lock_guard lock(m_mutex);
+
+      if (m_recycled_size.load(std::memory_order_relaxed) + seg.m_size <= m_policy.m_recycle_limit) {
+        m_recycled.push_back(seg);
+        m_recycled_size.fetch_add(seg.m_size, std::memory_order_relaxed);
+        return;
+      }
+    }
+
+    FreeSegment(seg);
+  }
+};
+
+/** A bump allocator over a list of segments. Not thread-safe by itself, but the
+ * accounting counters may be read concurrently from any thread. */
+class SegmentChain final {
+  SegmentSource &m_source;
+  std::vector<Segment> m_bases;
+  std::atomic<size_t> m_used = 0, m_managed = 0, m_segment_array = 0;
+  size_t m_next_size;
+
+  /* Only the owning thread writes the counters, so a plain store is enough */
+  static NCC_FORCE_INLINE void Bump(std::atomic<size_t> &counter, size_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+  /* Publish the footprint of the segment array after it may have grown */
+  NCC_FORCE_INLINE void UpdateSegmentArray() {
+    m_segment_array.store(m_bases.capacity() * sizeof(Segment), std::memory_order_relaxed);
+  }
+
+  void AllocPrimaryRegion() {
+    const auto &policy = m_source.GetPolicy();
+
+    m_bases.push_back(m_source.Acquire(m_next_size));
+    Bump(m_managed, m_bases.back().m_size);
+    UpdateSegmentArray();
+
+    m_next_size = std::min(m_next_size * policy.m_growth_factor, policy.m_max_segment);
+  }
+
+  auto AllocOversizedRegion(size_t size) -> Segment & {
+    /* Keep the primary segment at the back so that its remaining space is not
+     * abandoned because of a single large payload. */
+    auto it = m_bases.insert(m_bases.end() - 1, m_source.Acquire(size));
+    Bump(m_managed, it->m_size);
+    UpdateSegmentArray();
+
+    return *it;
   }
 
 public:
-  PImpl() {
+  SegmentChain(SegmentSource &source) : m_source(source), m_next_size(source.GetPolicy().m_initial_segment) {
     m_bases.reserve(64);
 
-    AllocRegion(kPrimarySegmentSize);
+    AllocPrimaryRegion();
   }
 
-  ~PImpl() {
-    for (auto &base : m_bases) {
-      delete[] base.m_base;
+  SegmentChain(const SegmentChain &) = delete;
+  SegmentChain(SegmentChain &&) = delete;
+
+  ~SegmentChain() {
+    for (const auto &base : m_bases) {
+      m_source.Release(base);
     }
   }
 
@@ -81,13 +237,10 @@ public:
     uint8_t *start;
     Segment *b;
 
-    SmartLock lock(m_mutex);
-
-    /* If the requested size plus the alignment is greater than the primary
-     * segment size, then allocate a new segment to store the payload. */
-    if (size + alignment > kPrimarySegmentSize) [[unlikely]] {
-      AllocRegion(size + alignment);
-      b = &m_bases.back();
+    /* If the requested size plus the alignment is greater than the largest
+     * primary segment size, then allocate a new segment to store the payload. */
+    if (size + alignment > m_source.GetPolicy().m_max_segment) [[unlikely]] {
+      b = &AllocOversizedRegion(size + alignment);
       start = ALIGNED(b->m_offset, alignment);
     } else {
       /* Otherwise, prepare to allocate in the current segment. */
@@ -95,17 +248,19 @@ public:
       start = ALIGNED(b->m_offset, alignment);
 
       /* If the requested size is greater than the remaining space in the
-       * current segment, allocate a new primary size segment to store the
-       * payload. */
-      if (start + size > b->m_base + b->m_size) [[unlikely]] {
-        AllocRegion(kPrimarySegmentSize);
+       * current segment, allocate a new primary segment to store the payload.
+       * Growth may still leave the next segment too small for this payload. */
+      while (start + size > b->m_base + b->m_size) [[unlikely]] {
+        AllocPrimaryRegion();
         b = &m_bases.back();
 
         start = ALIGNED(b->m_offset, alignment);
       }
     }
 
-    b->m_offset = start + size;
+    auto *end = start + size;
+    Bump(m_used, end - b->m_offset);
+    b->m_offset = end;
 
     /* Ensure that the returned space is within the bounds of the current
      * segment. */
@@ -114,48 +269,167 @@ public:
     return start;
   }
 
-  auto GetSpaceUsed() const -> size_t {
+  [[nodiscard]] auto GetSpaceUsed() const -> size_t { return m_used.load(std::memory_order_relaxed); }
+
+  [[nodiscard]] auto GetSpaceManaged() const -> size_t {
+    return m_managed.load(std::memory_order_relaxed) + m_segment_array.load(std::memory_order_relaxed) + sizeof(*this);
+  }
+};
+
+/** Per-thread region of a PerThread arena. Nodes are only ever prepended, and
+ * are only unlinked by Reset() or the destructor. */
+struct ThreadChain {
+  SegmentChain m_chain;
+  std::thread::id m_owner;
+  ThreadChain *m_next = nullptr;
+
+  ThreadChain(SegmentSource &source) : m_chain(source) {}
+};
+
+struct ThreadSlot {
+  uint64_t m_arena_id = 0;
+  ThreadChain *m_node = nullptr;
+};
+
+/* Direct-mapped, so the cache stays a fixed size no matter how many arenas a
+ * thread touches over its lifetime. A miss falls back to a list scan. */
+static thread_local std::array<ThreadSlot, kThreadCacheWays> ThreadCache;
+
+/* Arena identifiers are never reused, so stale cache slots can never alias a
+ * live arena even if its address is recycled. */
+static std::atomic<uint64_t> ArenaIdCounter = 1;
+
+class ncc::DynamicArena::PImpl final {
+  ArenaSync m_sync;
+  SegmentSource m_source;
+
+  /* ArenaSync::Shared */
+  std::optional<SegmentChain> m_shared;
+  mutable std::mutex m_mutex;
+
+  /* ArenaSync::PerThread */
+  std::atomic<uint64_t> m_id;
+  std::atomic<ThreadChain *> m_threads = nullptr;
+
+  auto FindThreadChain() -> SegmentChain & {
+    const auto id = m_id.load(std::memory_order_acquire);
+    auto &slot = ThreadCache[id % kThreadCacheWays];
+
+    if (slot.m_arena_id == id) [[likely]] {
+      return slot.m_node->m_chain;
+    }
+
+    /* The slot was evicted by another arena; search for a region that this
+     * thread has already created before making a new one. */
+    const auto self = std::this_thread::get_id();
+
+    auto *node = m_threads.load(std::memory_order_acquire);
+    while (node != nullptr && node->m_owner != self) {
+      node = node->m_next;
+    }
+
+    if (node == nullptr) {
+      node = new ThreadChain(m_source);
+      node->m_owner = self;
+      node->m_next = m_threads.load(std::memory_order_relaxed);
+
+      while (!m_threads.compare_exchange_weak(node->m_next, node, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+      }
+    }
+
+    slot = {id, node};
+
+    return node->m_chain;
+  }
+
+  void ReleaseThreadChains() {
+    auto *node = m_threads.exchange(nullptr, std::memory_order_acq_rel);
+
+    while (node != nullptr) {
+      auto *next = node->m_next;
+      delete node;
+      node = next;
+    }
+  }
+
+public:
+  PImpl(ArenaSync sync, ArenaPolicy policy)
+      : m_sync(sync), m_source(policy), m_id(ArenaIdCounter.fetch_add(1, std::memory_order_relaxed)) {
+    if (m_sync == ArenaSync::Shared) {
+      m_shared.emplace(m_source);
+    }
+  }
+
+  ~PImpl() { ReleaseThreadChains(); }
+
+  [[nodiscard]] auto GetSync() const -> ArenaSync { return m_sync; }
+  [[nodiscard]] auto GetPolicy() const -> const ArenaPolicy & { return m_source.GetPolicy(); }
+
+  auto Allocate(size_t size, size_t alignment) -> void * {
+    if (m_sync == ArenaSync::PerThread) {
+      return FindThreadChain().Allocate(size, alignment);
+    }
+
     SmartLock lock(m_mutex);
+    return m_shared->Allocate(size, alignment);
+  }
 
+  auto GetSpaceUsed() const -> size_t {
     size_t total = 0;
-    for (const auto &base : m_bases) {
-      total += base.m_offset - base.m_base;
+
+    if (m_sync == ArenaSync::PerThread) {
+      for (auto *node = m_threads.load(std::memory_order_acquire); node != nullptr; node = node->m_next) {
+        total += node->m_chain.GetSpaceUsed();
+      }
+    } else {
+      SmartLock lock(m_mutex);
+      total += m_shared->GetSpaceUsed();
     }
 
     return total;
   }
 
   auto GetSpaceManaged() const -> size_t {
-    SmartLock lock(m_mutex);
-
     size_t total = 0;
-    for (const auto &base : m_bases) {
-      total += base.m_size;
+
+    if (m_sync == ArenaSync::PerThread) {
+      for (auto *node = m_threads.load(std::memory_order_acquire); node != nullptr; node = node->m_next) {
+        total += node->m_chain.GetSpaceManaged() + sizeof(ThreadChain) - sizeof(SegmentChain);
+      }
+    } else {
+      SmartLock lock(m_mutex);
+      total += m_shared->GetSpaceManaged();
     }
 
-    total += m_bases.capacity() * sizeof(Segment);
+    total += m_source.GetRecycledSize();
     total += sizeof(*this);
 
     return total;
   }
 
   auto Reset() -> void {
-    SmartLock lock(m_mutex);
-
-    for (auto &base : m_bases) {
-      delete[] base.m_base;
+    if (m_sync == ArenaSync::PerThread) {
+      /* A fresh identifier invalidates every thread's cached slot at once */
+      m_id.store(ArenaIdCounter.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+      ReleaseThreadChains();
+      return;
     }
 
-    m_bases.clear();
+    SmartLock lock(m_mutex);
 
-    AllocRegion(kPrimarySegmentSize);
+    /* Releases every segment to the source before the new chain draws from
+     * its recycled pool. */
+    m_shared.emplace(m_source);
   }
 };
 
-DynamicArena::DynamicArena() { m_pimpl = new PImpl(); }
+DynamicArena::DynamicArena(ArenaSync sync, ArenaPolicy policy) { m_pimpl = new PImpl(sync, policy); }
 DynamicArena::~DynamicArena() { delete m_pimpl; }
 auto DynamicArena::GetSpaceUsed() const -> size_t { return m_pimpl->GetSpaceUsed(); }
 auto DynamicArena::GetSpaceManaged() const -> size_t { return m_pimpl->GetSpaceManaged(); }
+auto DynamicArena::GetSync() const -> ArenaSync { return m_pimpl->GetSync(); }
+auto DynamicArena::GetPolicy() const -> const ArenaPolicy & { return m_pimpl->GetPolicy(); }
 void DynamicArena::Reset() { m_pimpl->Reset(); }
 
 void *DynamicArena::do_allocate(size_t bytes, size_t alignment) { return m_pimpl->Allocate(bytes, alignment); }
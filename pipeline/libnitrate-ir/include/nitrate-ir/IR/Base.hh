@@ -80,7 +80,7 @@ namespace ncc::ir {
     constexpr GenericExpr(nr_ty_t ty, lex::LocationID begin = lex::LocationID(),
                           lex::LocationID end = lex::LocationID())
         : m_node_type(ty) {
-      m_loc = parse::ExtensionDataStore.Add(begin, end);
+      m_loc = parse::ExtensionDataStore.Add(begin, end, *NrAllocator);
     }
 
     static constexpr auto GetKindSize(nr_ty_t type) -> uint32_t;
@@ -236,7 +236,7 @@ namespace ncc::ir {
     constexpr void SetLoc(SrcLoc loc) { m_loc = loc; }
 
     constexpr void SetLoc(lex::LocationID begin, lex::LocationID end) {
-      m_loc = parse::ExtensionDataStore.Add(begin, end);
+      m_loc = parse::ExtensionDataStore.Add(begin, end, *NrAllocator);
     }
 
     auto GetType() -> std::optional<FlowPtr<Type>> { return detail::ExprGetType(reinterpret_cast<Expr *>(this)); }
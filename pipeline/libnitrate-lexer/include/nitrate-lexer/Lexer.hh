@@ -35,19 +35,45 @@
 #define __NITRATE_LEXER_LEX_HH__
 
 #include <memory>
+#include <string>
+#include <string_view>
 #include <nitrate-core/EnvironmentFwd.hh>
 #include <nitrate-core/Macro.hh>
 #include <nitrate-lexer/Scanner.hh>
 
 namespace ncc::lex {
+  /** A read-only memory mapping of a source file. */
+  class NCC_EXPORT MappedSourceFile final : public ISourceFile {
+    void *m_base = nullptr;
+    size_t m_size = 0;
+
+    MappedSourceFile(void *base, size_t size) : m_base(base), m_size(size) {}
+
+  public:
+    MappedSourceFile(const MappedSourceFile &) = delete;
+    ~MappedSourceFile() override;
+
+    /** @return nullptr if the file could not be opened or mapped. */
+    static auto Open(const std::string &path) -> std::shared_ptr<MappedSourceFile>;
+
+    [[nodiscard]] auto GetContent() const -> std::string_view override;
+  };
+
   class NCC_EXPORT Tokenizer final : public IScanner {
     class Impl;
     std::unique_ptr<Impl> m_impl;
 
     auto GetNext() -> Token override;
+    auto GetLocationFallback(LocationID id) -> std::optional<Location> override;
 
   public:
     Tokenizer(std::istream &source_file, std::shared_ptr<IEnvironment> env);
+
+    /** Scan a contiguous buffer in place. The buffer must outlive the tokenizer. */
+    Tokenizer(std::string_view source, std::shared_ptr<IEnvironment> env);
+
+    /** Scan a source file in place, sharing ownership of it. */
+    Tokenizer(std::shared_ptr<ISourceFile> source, std::shared_ptr<IEnvironment> env);
     Tokenizer(Tokenizer &&) noexcept;
     ~Tokenizer() override;
 
@@ -56,6 +82,9 @@ namespace ncc::lex {
 
     auto SetCurrentFilename(string filename) -> string;
     [[nodiscard]] auto GetCurrentFilename() -> string;
+
+    /** Name of the byte scanning kernels selected for this host ("scalar", "sse4.2" or "avx2"). */
+    [[nodiscard]] static auto GetScanKernelName() -> std::string_view;
   };
 }  // namespace ncc::lex
 
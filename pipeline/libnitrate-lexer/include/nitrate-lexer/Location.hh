@@ -67,10 +67,17 @@ namespace ncc::lex {
   public:
     using Counter = uint32_t;
 
+    /** IDs with this bit set hold a byte offset that the scanner resolves on demand. */
+    static constexpr Counter kOffsetBit = Counter(1) << 31;
+
     constexpr explicit LocationID(Counter id = 0) : m_id(id) {}
 
+    static constexpr auto FromOffset(uint32_t offset) -> LocationID { return LocationID(offset | kOffsetBit); }
+
     auto Get(IScanner &l) const -> Location;
     [[nodiscard]] constexpr auto GetId() const -> Counter { return m_id; }
+    [[nodiscard]] constexpr auto IsOffset() const -> bool { return (m_id & kOffsetBit) != 0; }
+    [[nodiscard]] constexpr auto GetOffset() const -> uint32_t { return m_id & ~kOffsetBit; }
 
     [[nodiscard]] constexpr auto operator==(const LocationID &rhs) const -> bool { return m_id == rhs.m_id; }
     [[nodiscard]] constexpr auto operator<(const LocationID &rhs) const -> bool { return m_id < rhs.m_id; }
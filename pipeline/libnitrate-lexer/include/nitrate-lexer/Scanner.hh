@@ -39,15 +39,15 @@
 #include <nitrate-core/Macro.hh>
 #include <nitrate-core/Testing.hh>
 #include <nitrate-lexer/Token.hh>
+#include <string_view>
 
 namespace ncc::lex {
-  namespace detail {
-    struct ScannerEOF final {};
-  }  // namespace detail
-
   class ISourceFile {
   public:
     virtual ~ISourceFile() = default;
+
+    /** Contiguous source text; valid for the lifetime of this object. */
+    [[nodiscard]] virtual auto GetContent() const -> std::string_view = 0;
   };
 
   /**
@@ -111,6 +111,17 @@ namespace ncc::lex {
      */
     [[nodiscard]] auto Peek() -> Token;
 
+    /**
+     * Copies the token `n` positions ahead in the VTQ model without consuming
+     * anything; `Peek(0)` is equivalent to `Peek()`. Skipped comments are not
+     * counted. Unlike `Peek()`, looking further ahead does not change the
+     * value returned by `Current()`.
+     *
+     * @note Lookahead is meant to be short (a few tokens); the underlying
+     *       buffer grows to accommodate larger distances.
+     */
+    [[nodiscard]] auto Peek(size_t n) -> Token;
+
     /**
      * Inserts a token into the front of the VTQ model.
      *
@@ -31,6 +31,7 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <array>
 #include <boost/bimap.hpp>
 #include <boost/multiprecision/cpp_dec_float.hpp>
@@ -41,31 +42,41 @@
 #include <csetjmp>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <google/dense_hash_map>
 #include <google/dense_hash_set>
 #include <iostream>
+#include <limits>
 #include <nitrate-core/Logger.hh>
 #include <nitrate-core/Macro.hh>
 #include <nitrate-core/String.hh>
 #include <nitrate-lexer/Grammar.hh>
 #include <nitrate-lexer/Lexer.hh>
 #include <nitrate-lexer/Token.hh>
+#include <optional>
 #include <sstream>
-#include <stack>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "EC.hh"
+#include "ScanKernels.hh"
 
 using namespace ncc;
 using namespace ncc::lex;
 using namespace ncc::lex::detail;
 
 static constexpr size_t kFloatingPointDigits = 128;
+static constexpr size_t kFastFloatMaxDigits = 50;
+static constexpr int32_t kFastFloatMaxExponent = 99;
 static constexpr size_t kGetcBufferSize = 512;
 
+/* Fed to the automata once the input and its padding are exhausted. It is not
+ * whitespace and cannot start or continue any token. */
+static constexpr uint8_t kEofSentinel = 0xff;
+
 enum NumberKind : uint8_t {
   DecNum,
   ExpDec,
@@ -169,46 +180,6 @@ static constexpr auto kNibbleTable = []() {
   return hextable;
 }();
 
-static constexpr auto kWhitespaceTable = []() {
-  std::array<bool, 256> tab = {};
-
-  tab[' '] = true;
-  tab['\f'] = true;
-  tab['\n'] = true;
-  tab['\r'] = true;
-  tab['\t'] = true;
-  tab['\v'] = true;
-  tab['\\'] = true;
-  tab['\0'] = true;  // Null byte is also a whitespace character
-
-  return tab;
-}();
-
-static constexpr auto kIdentifierCharTable = []() {
-  std::array<bool, 256> tab = {};
-
-  for (uint8_t c = 'a'; c <= 'z'; ++c) {
-    tab[c] = true;
-  }
-
-  for (uint8_t c = 'A'; c <= 'Z'; ++c) {
-    tab[c] = true;
-  }
-
-  for (uint8_t c = '0'; c <= '9'; ++c) {
-    tab[c] = true;
-  }
-
-  tab['_'] = true;
-
-  /* Support UTF-8 */
-  for (uint8_t c = 0x80; c < 0xff; c++) {
-    tab[c] = true;
-  }
-
-  return tab;
-}();
-
 static constexpr auto kMacroCallCharTable = []() {
   std::array<bool, 256> tab = {};
 
@@ -360,44 +331,47 @@ constexpr auto kCharMap = []() constexpr {
 }();
 
 /// https://stackoverflow.com/questions/1031645/how-to-detect-utf-8-in-plain-c
-static auto IsUtf8(const char *string) -> bool {
-  qcore_assert(string != nullptr);
+static auto IsUtf8(std::string_view string) -> bool {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(string.data());
+  const auto *end = bytes + string.size();
 
-  const auto *bytes = (const unsigned char *)string;
-  while (*bytes != 0U) {
+  /* Bytes past the end read as NUL, which never continues a sequence */
+  const auto at = [&](size_t i) -> unsigned char { return bytes + i < end ? bytes[i] : 0; };
+
+  while (bytes < end) {
     if ((  // ASCII
            // use bytes[0] <= 0x7F to allow ASCII control characters
-            bytes[0] == 0x09 || bytes[0] == 0x0A || bytes[0] == 0x0D || (0x20 <= bytes[0] && bytes[0] <= 0x7E))) {
+            at(0) == 0x09 || at(0) == 0x0A || at(0) == 0x0D || (0x20 <= at(0) && at(0) <= 0x7E))) {
       bytes += 1;
       continue;
     }
 
     if ((  // non-overlong 2-byte
-            (0xC2 <= bytes[0] && bytes[0] <= 0xDF) && (0x80 <= bytes[1] && bytes[1] <= 0xBF))) {
+            (0xC2 <= at(0) && at(0) <= 0xDF) && (0x80 <= at(1) && at(1) <= 0xBF))) {
       bytes += 2;
       continue;
     }
 
     if ((  // excluding overlongs
-            bytes[0] == 0xE0 && (0xA0 <= bytes[1] && bytes[1] <= 0xBF) && (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
+            at(0) == 0xE0 && (0xA0 <= at(1) && at(1) <= 0xBF) && (0x80 <= at(2) && at(2) <= 0xBF)) ||
         (  // straight 3-byte
-            ((0xE1 <= bytes[0] && bytes[0] <= 0xEC) || bytes[0] == 0xEE || bytes[0] == 0xEF) &&
-            (0x80 <= bytes[1] && bytes[1] <= 0xBF) && (0x80 <= bytes[2] && bytes[2] <= 0xBF)) ||
+            ((0xE1 <= at(0) && at(0) <= 0xEC) || at(0) == 0xEE || at(0) == 0xEF) &&
+            (0x80 <= at(1) && at(1) <= 0xBF) && (0x80 <= at(2) && at(2) <= 0xBF)) ||
         (  // excluding surrogates
-            bytes[0] == 0xED && (0x80 <= bytes[1] && bytes[1] <= 0x9F) && (0x80 <= bytes[2] && bytes[2] <= 0xBF))) {
+            at(0) == 0xED && (0x80 <= at(1) && at(1) <= 0x9F) && (0x80 <= at(2) && at(2) <= 0xBF))) {
       bytes += 3;
       continue;
     }
 
     if ((  // planes 1-3
-            bytes[0] == 0xF0 && (0x90 <= bytes[1] && bytes[1] <= 0xBF) && (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
-            (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
+            at(0) == 0xF0 && (0x90 <= at(1) && at(1) <= 0xBF) && (0x80 <= at(2) && at(2) <= 0xBF) &&
+            (0x80 <= at(3) && at(3) <= 0xBF)) ||
         (  // planes 4-15
-            (0xF1 <= bytes[0] && bytes[0] <= 0xF3) && (0x80 <= bytes[1] && bytes[1] <= 0xBF) &&
-            (0x80 <= bytes[2] && bytes[2] <= 0xBF) && (0x80 <= bytes[3] && bytes[3] <= 0xBF)) ||
+            (0xF1 <= at(0) && at(0) <= 0xF3) && (0x80 <= at(1) && at(1) <= 0xBF) &&
+            (0x80 <= at(2) && at(2) <= 0xBF) && (0x80 <= at(3) && at(3) <= 0xBF)) ||
         (  // plane 16
-            bytes[0] == 0xF4 && (0x80 <= bytes[1] && bytes[1] <= 0x8F) && (0x80 <= bytes[2] && bytes[2] <= 0xBF) &&
-            (0x80 <= bytes[3] && bytes[3] <= 0xBF))) {
+            at(0) == 0xF4 && (0x80 <= at(1) && at(1) <= 0x8F) && (0x80 <= at(2) && at(2) <= 0xBF) &&
+            (0x80 <= at(3) && at(3) <= 0xBF))) {
       bytes += 4;
       continue;
     }
@@ -416,55 +390,95 @@ class Tokenizer::Impl {
 public:
   std::string m_buf;
 
-  std::stack<char> m_rewind;
+  std::vector<uint8_t> m_rewind;
 
   uint32_t m_offset = 0;
-  uint32_t m_line = 0;
-  uint32_t m_column = 0;
 
-  uint32_t m_getc_buffer_pos = kGetcBufferSize;
-  std::istream &m_file;
+  /* Offset of the first character of every line seen so far. Token locations
+   * are plain offsets and are only turned into line/column pairs on demand. */
+  std::vector<uint32_t> m_line_starts = {0};
+
+  /* The unread part of the current input window. In stream mode the window is
+   * m_getc_buffer; in contiguous mode it is the whole source text. */
+  const uint8_t *m_window = nullptr;
+  const uint8_t *m_cur = nullptr;
+  const uint8_t *m_lim = nullptr;
+
+  std::istream *m_file = nullptr;
+  std::string_view m_source;
+  std::shared_ptr<ISourceFile> m_source_owner;
   std::array<char, kGetcBufferSize> m_getc_buffer;
 
+  const ScanKernels &m_kernels = GetScanKernels();
+
   string m_filename;
   bool m_at_end = false;
+  bool m_eof = false;
   bool m_parsing = false;
 
   std::function<void()> m_on_eof;
 
   ///============================================================================///
 
-  Impl(std::istream &file, std::function<void()> on_eof) : m_file(file), m_on_eof(std::move(on_eof)) {}
+  Impl(std::istream &file, std::function<void()> on_eof) : m_file(&file), m_on_eof(std::move(on_eof)) {}
+
+  Impl(std::string_view source, std::function<void()> on_eof) : m_source(source), m_on_eof(std::move(on_eof)) {
+    m_window = reinterpret_cast<const uint8_t *>(m_source.data());
+    m_cur = m_window;
+    m_lim = m_window + m_source.size();
+  }
+
+  [[nodiscard]] auto IsContiguous() const -> bool { return m_file == nullptr; }
+
+  [[nodiscard]] auto Resolve(uint32_t offset) const -> Location {
+    auto it = std::upper_bound(m_line_starts.begin(), m_line_starts.end(), offset);
+    auto line = static_cast<uint32_t>(std::distance(m_line_starts.begin(), it) - 1);
+
+    return {offset, line, offset - m_line_starts[line], m_filename};
+  }
 
   [[nodiscard]] [[gnu::noinline]] std::string LogSource() const {
     std::stringstream ss;
     ss << "at (";
 
+    auto here = Resolve(m_offset);
+
     ss << (m_filename->empty() ? "?" : *m_filename) << ":";
-    ss << m_line + 1 << ":" << m_column + 1 << "): ";
+    ss << here.GetRow() + 1 << ":" << here.GetCol() + 1 << "): ";
 
     return ss.str();
   }
 
   [[gnu::noinline]] void ResetAutomaton() {
-    m_rewind = {};
+    m_rewind.clear();
     m_buf.clear();
   }
 
   void RefillCharacterBuffer() {
-    m_file.read(m_getc_buffer.data(), kGetcBufferSize);
-    auto gcount = m_file.gcount();
+    /* A contiguous source is handed out as a single window, so running off its
+     * end is the same as a stream read returning nothing. */
+    size_t gcount = 0;
+    if (m_file != nullptr) {
+      m_file->read(m_getc_buffer.data(), kGetcBufferSize);
+      gcount = m_file->gcount();
+    }
 
     if (gcount == 0) [[unlikely]] {
       if (m_at_end) [[unlikely]] {
-        if (m_parsing) [[unlikely]] {
+        if (m_parsing && !m_eof) [[unlikely]] {
           Log << UnexpectedEOF << "Unexpected EOF while reading file";
           m_on_eof();
         }
 
-        // Benchmarks show that this is the fastest way to signal EOF
-        // for large files.
-        throw ScannerEOF();
+        /* The padding is used up too. Keep handing out the sentinel so every
+         * automaton stops, and let GetNext() report the end of file. */
+        m_eof = true;
+        memset(m_getc_buffer.data(), kEofSentinel, kGetcBufferSize);
+
+        m_window = reinterpret_cast<const uint8_t *>(m_getc_buffer.data());
+        m_cur = m_window;
+        m_lim = m_window + kGetcBufferSize;
+        return;
       }
 
       m_at_end = true;
@@ -472,37 +486,65 @@ public:
 
     // Fill extra buffer with '#' with is a comment character
     memset(m_getc_buffer.data() + gcount, '\n', kGetcBufferSize - gcount);
-    m_getc_buffer_pos = 0;
+
+    m_window = reinterpret_cast<const uint8_t *>(m_getc_buffer.data());
+    m_cur = m_window;
+    m_lim = m_window + kGetcBufferSize;
+  }
+
+  /* Consume the window bytes [m_cur, end), none of which may be rewound. */
+  void ConsumeSpan(const uint8_t *end) {
+    if (m_kernels.m_count_newlines(m_cur, end) != 0) {
+      const auto *p = m_cur;
+      while ((p = static_cast<const uint8_t *>(memchr(p, '\n', end - p))) != nullptr) {
+        p++;
+        m_line_starts.push_back(m_offset + static_cast<uint32_t>(p - m_cur));
+      }
+    }
+
+    m_offset += static_cast<uint32_t>(end - m_cur);
+    m_cur = end;
+  }
+
+  /* If the byte `c` that was just consumed came straight from the window, and
+   * nothing is waiting to be rewound, return its address in the window. */
+  [[nodiscard]] auto InPlace(uint8_t c) const -> const uint8_t * {
+    if (m_rewind.empty() && m_cur > m_window && m_cur[-1] == c) [[likely]] {
+      return m_cur - 1;
+    }
+
+    return nullptr;
   }
 
   auto NextCharIf(uint8_t cmp) -> bool {
     uint8_t c;
 
     if (!m_rewind.empty()) {
-      c = m_rewind.top();
+      c = m_rewind.back();
 
       if (c != cmp) {
         return false;
       }
 
-      m_rewind.pop();
+      m_rewind.pop_back();
     } else {
-      if (m_getc_buffer_pos == kGetcBufferSize) [[unlikely]] {
+      if (m_cur == m_lim) [[unlikely]] {
         RefillCharacterBuffer();
       }
 
-      c = m_getc_buffer[m_getc_buffer_pos];
+      c = *m_cur;
 
       if (c != cmp) {
         return false;
       }
 
-      m_getc_buffer_pos++;
+      m_cur++;
     }
 
     m_offset += 1;
-    m_line = m_line + static_cast<uint32_t>(c == '\n');
-    m_column = static_cast<uint32_t>(c != '\n') * (m_column + 1);
+    if (c == '\n') [[unlikely]] {
+      m_line_starts.push_back(m_offset);
+    }
 
     return true;
   }
@@ -511,19 +553,20 @@ public:
     uint8_t c;
 
     if (!m_rewind.empty()) {
-      c = m_rewind.top();
-      m_rewind.pop();
+      c = m_rewind.back();
+      m_rewind.pop_back();
     } else {
-      if (m_getc_buffer_pos == kGetcBufferSize) [[unlikely]] {
+      if (m_cur == m_lim) [[unlikely]] {
         RefillCharacterBuffer();
       }
 
-      c = m_getc_buffer[m_getc_buffer_pos++];
+      c = *m_cur++;
     }
 
     m_offset += 1;
-    m_line = m_line + static_cast<uint32_t>(c == '\n');
-    m_column = static_cast<uint32_t>(c != '\n') * (m_column + 1);
+    if (c == '\n') [[unlikely]] {
+      m_line_starts.push_back(m_offset);
+    }
 
     return c;
   }
@@ -532,13 +575,13 @@ public:
     uint8_t c;
 
     if (!m_rewind.empty()) {
-      c = m_rewind.top();
+      c = m_rewind.back();
     } else {
-      if (m_getc_buffer_pos == kGetcBufferSize) [[unlikely]] {
+      if (m_cur == m_lim) [[unlikely]] {
         RefillCharacterBuffer();
       }
 
-      c = m_getc_buffer[m_getc_buffer_pos];
+      c = *m_cur;
     }
 
     return c;
@@ -553,10 +596,97 @@ public:
     return std::from_chars(buf.data(), buf.data() + buf.size(), _).ptr == buf.data() + buf.size();
   }
 
+  static auto IsPlainDecimal(std::string_view buf) -> bool {
+    bool seen_dot = false;
+    for (char c : buf) {
+      if (c == '.' && !seen_dot) {
+        seen_dot = true;
+      } else if (c < '0' || c > '9') {
+        return false;
+      }
+    }
+
+    return !buf.empty() && buf.front() != '.';
+  }
+
+  /* Shift the decimal point of an exact literal like "6.022e23" instead of
+   * evaluating it in arbitrary precision. Produces the same text as the
+   * cpp_dec_float path for every input it accepts and returns false for the
+   * rest (fractional or large exponents, long mantissas, unusual digits). */
+  static auto CanonicalizeFloatExact(std::string &buf, size_t e_pos) -> bool {
+    const std::string_view mantissa = std::string_view(buf).substr(0, e_pos);
+    std::string_view exponent = std::string_view(buf).substr(e_pos + 1);
+
+    if (mantissa.size() > kFastFloatMaxDigits || !IsPlainDecimal(mantissa)) {
+      return false;
+    }
+
+    if (exponent.starts_with('+')) {
+      exponent.remove_prefix(1);
+    }
+
+    int32_t shift = 0;
+    if (auto [ptr, ec] = std::from_chars(exponent.data(), exponent.data() + exponent.size(), shift);
+        ec != std::errc() || ptr != exponent.data() + exponent.size() || shift > kFastFloatMaxExponent ||
+        shift < -kFastFloatMaxExponent) {
+      return false;
+    }
+
+    std::array<char, kFastFloatMaxDigits> digits;
+    size_t digit_count = 0;
+    auto point = static_cast<int32_t>(mantissa.size());
+    for (size_t i = 0; i < mantissa.size(); ++i) {
+      if (mantissa[i] == '.') {
+        point = static_cast<int32_t>(i);
+      } else {
+        digits[digit_count++] = mantissa[i];
+      }
+    }
+    point += shift;
+
+    const auto digit_at = [&](int32_t i) { return i >= 0 && i < static_cast<int32_t>(digit_count) ? digits[i] : '0'; };
+
+    std::array<char, (kFastFloatMaxDigits + kFastFloatMaxExponent) * 2 + 2> out;
+    size_t out_size = 0;
+
+    int32_t first = 0;
+    while (first < point - 1 && digit_at(first) == '0') {
+      ++first;
+    }
+    for (int32_t i = first; i < point; ++i) {
+      out[out_size++] = digit_at(i);
+    }
+    if (out_size == 0) {
+      out[out_size++] = '0';
+    }
+
+    out[out_size++] = '.';
+
+    auto last = std::max(static_cast<int32_t>(digit_count), point + 1);
+    while (last > point + 1 && digit_at(last - 1) == '0') {
+      --last;
+    }
+    if (last - point > static_cast<int32_t>(kFloatingPointDigits)) {
+      return false;
+    }
+
+    for (int32_t i = point; i < last; ++i) {
+      out[out_size++] = digit_at(i);
+    }
+
+    buf.assign(out.data(), out_size);
+
+    return true;
+  }
+
   auto CanonicalizeFloat(std::string &buf) const -> bool {
     const auto e_pos = buf.find('e');
     if (e_pos == std::string::npos) [[likely]] {
-      return CheckFloat(buf);
+      return IsPlainDecimal(buf) || CheckFloat(buf);
+    }
+
+    if (CanonicalizeFloatExact(buf, e_pos)) [[likely]] {
+      return true;
     }
 
     qcore_assert(e_pos != 0 && e_pos != buf.size() - 1);
@@ -590,8 +720,22 @@ public:
   }
 
   auto CanonicalizeNumber(std::string &buf, NumberKind type) const -> bool {
-    std::transform(buf.begin(), buf.end(), buf.begin(), ::tolower);
-    std::erase(buf, '_');
+    /* Plain decimals that fit in 64 bits are by far the most common literal */
+    if (type == DecNum && buf.size() <= std::numeric_limits<uint64_t>::digits10) [[likely]] {
+      uint64_t value = 0;
+      const auto *end = buf.data() + buf.size();
+      if (auto [ptr, ec] = std::from_chars(buf.data(), end, value); ec == std::errc() && ptr == end) [[likely]] {
+        std::array<char, std::numeric_limits<uint64_t>::digits10 + 1> digits;
+        auto [digits_end, _] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        buf.assign(digits.data(), digits_end);
+        return true;
+      }
+    }
+
+    if (std::any_of(buf.begin(), buf.end(), [](char c) { return c == '_' || (c >= 'A' && c <= 'Z'); })) [[unlikely]] {
+      std::transform(buf.begin(), buf.end(), buf.begin(), ::tolower);
+      std::erase(buf, '_');
+    }
 
     boost::uint128_type x = 0;
 
@@ -727,41 +871,77 @@ public:
       }
     }
 
-    while (kIdentifierCharTable[c]) {
-      m_buf += c;
-      c = NextChar();
+    std::string_view lexeme;
+
+    /* Find the end of the identifier inside the window and look it up without
+     * copying it into m_buf first. */
+    if (const auto *begin = InPlace(c)) [[likely]] {
+      const auto *end = m_kernels.m_find_identifier_end(m_cur, m_lim);
+      if (end != m_lim) [[likely]] {
+        ConsumeSpan(end);
+        c = NextChar();
+
+        lexeme = std::string_view(reinterpret_cast<const char *>(begin), end - begin);
+      }
     }
 
-    m_rewind.push(c);
+    if (lexeme.data() == nullptr) [[unlikely]] {
+      while (kIdentifierCharTable[c]) {
+        m_buf += c;
+        c = NextChar();
+      }
+
+      lexeme = m_buf;
+    }
+
+    m_rewind.push_back(c);
 
     { /* Determine if it's a keyword */
-      auto it = KEYWORDS_MAP.find(m_buf);
+      auto it = KEYWORDS_MAP.find(lexeme);
       if (it != KEYWORDS_MAP.end()) {
         return {KeyW, it->second, start_pos};
       }
     }
 
     { /* Determine if it's an operator */
-      auto it = WORD_OPERATORS.find(m_buf);
+      auto it = WORD_OPERATORS.find(lexeme);
       if (it != WORD_OPERATORS.end()) {
         return {Oper, it->second, start_pos};
       }
     }
 
-    if (!IsUtf8(m_buf.c_str())) [[unlikely]] {
+    if (!IsUtf8(lexeme)) [[unlikely]] {
       Log << InvalidUTF8 << LogSource() << "Invalid UTF-8 sequence in identifier";
       return Token::EndOfFile();
     }
 
-    return {Name, string(std::move(m_buf)), start_pos};
+    return {Name, string(lexeme), start_pos};
   };
 
   auto ParseString(uint8_t c, LocationID start_pos) -> Token {
     auto quote = c;
     c = NextChar();
 
+    /* Content of a single-part literal without escapes, still in the window */
+    std::optional<std::string_view> in_place;
+
     while (true) {
+      if (const auto *begin = InPlace(c); begin != nullptr && m_buf.empty() && !in_place) [[likely]] {
+        const auto find = quote == '"' ? m_kernels.m_find_dquote_or_escape : m_kernels.m_find_squote_or_escape;
+        const auto *end = find(begin, m_lim);
+        if (end != m_lim && *end == quote) [[likely]] {
+          ConsumeSpan(end + 1);
+          c = quote;
+
+          in_place = std::string_view(reinterpret_cast<const char *>(begin), end - begin);
+        }
+      }
+
       while (c != quote) [[likely]] {
+        if (m_eof) [[unlikely]] {
+          return Token::EndOfFile();
+        }
+
         if (c != '\\') [[likely]] {
           m_buf += c;
           c = NextChar();
@@ -879,6 +1059,12 @@ public:
       }
 
       while (!m_at_end) {
+        if (in_place && m_cur == m_lim) [[unlikely]] {
+          /* A refill would overwrite the window the literal points into */
+          m_buf.assign(*in_place);
+          in_place.reset();
+        }
+
         c = PeekChar();
         if (kWhitespaceTable[c]) {
           NextChar();
@@ -889,21 +1075,28 @@ public:
 
       /* Check for a multi-part string */
       if (c == quote) {
+        if (in_place) {
+          m_buf.assign(*in_place);
+          in_place.reset();
+        }
+
         NextChar();
         c = NextChar();
         continue;
       }
 
-      if (quote == '\'' && m_buf.size() == 1) {
-        return {Char, string(std::string_view(m_buf.data(), 1)), start_pos};
+      const std::string_view content = in_place.value_or(m_buf);
+
+      if (quote == '\'' && content.size() == 1) {
+        return {Char, string(content), start_pos};
       }
 
-      return {Text, string(std::move(m_buf)), start_pos};
+      return {Text, string(content), start_pos};
     }
   }
 
   void ParseIntegerUnwind(uint8_t c, NumberKind kind, std::string &buf) {
-    m_rewind.push(c);
+    m_rewind.push_back(c);
 
     switch (kind) {
       case DecNum:
@@ -911,7 +1104,7 @@ public:
         while (!buf.empty()) {
           auto ch = buf.back();
           if (!kDigitsTable[ch]) {
-            m_rewind.push(ch);
+            m_rewind.push_back(ch);
             buf.pop_back();
           } else {
             break;
@@ -930,7 +1123,7 @@ public:
         while (!buf.empty()) {
           auto ch = buf.back();
           if (ch != '0' && ch != '1') {
-            m_rewind.push(ch);
+            m_rewind.push_back(ch);
             buf.pop_back();
           } else {
             break;
@@ -944,7 +1137,7 @@ public:
         while (!buf.empty()) {
           auto ch = buf.back();
           if (!kOctalDigitsTable[ch]) {
-            m_rewind.push(ch);
+            m_rewind.push_back(ch);
             buf.pop_back();
           } else {
             break;
@@ -958,7 +1151,7 @@ public:
         while (!buf.empty()) {
           auto ch = buf.back();
           if (!kDigitsTable[ch]) {
-            m_rewind.push(ch);
+            m_rewind.push_back(ch);
             buf.pop_back();
           } else {
             break;
@@ -1070,11 +1263,21 @@ public:
   }
 
   auto ParseCommentSingleLine(LocationID start_pos) -> Token {
+    if (m_rewind.empty() && m_cur != m_lim) [[likely]] {
+      const auto *begin = m_cur;
+      const auto *end = static_cast<const uint8_t *>(memchr(begin, '\n', m_lim - begin));
+      if (end != nullptr) [[likely]] {
+        ConsumeSpan(end + 1);
+
+        return {Note, string(std::string_view(reinterpret_cast<const char *>(begin), end - begin)), start_pos};
+      }
+    }
+
     uint8_t c;
 
     while (true) {
       c = NextChar();
-      if (c == '\n') {
+      if (c == '\n' || m_eof) {
         break;
       }
 
@@ -1087,7 +1290,7 @@ public:
   auto ParseCommentMultiLine(LocationID start_pos) -> Token {
     size_t depth = 1;
 
-    while (true) {
+    while (!m_eof) {
       auto c = NextChar();
 
       /* Support for nested comments */
@@ -1108,6 +1311,8 @@ public:
 
       m_buf += c;
     }
+
+    return Token::EndOfFile();
   }
 
   auto ParseSingleLineMacro(LocationID start_pos) -> Token {
@@ -1122,7 +1327,7 @@ public:
       NextChar();
     }
 
-    if (!IsUtf8(m_buf.c_str())) [[unlikely]] {
+    if (!IsUtf8(m_buf)) [[unlikely]] {
       Log << InvalidUTF8 << LogSource() << "Invalid UTF-8 sequence in macro";
       return Token::EndOfFile();
     }
@@ -1191,7 +1396,7 @@ public:
       return Token::EndOfFile();
     }
 
-    m_rewind.push(m_buf.back());
+    m_rewind.push_back(m_buf.back());
 
     return {Oper, OPERATORS_MAP.find(m_buf.substr(0, m_buf.size() - 1))->second, start_pos};
   }
@@ -1202,14 +1407,27 @@ auto Tokenizer::GetNext() -> Token {
   impl.m_buf.clear();
   impl.m_parsing = false;
 
+  if (impl.m_eof) [[unlikely]] {
+    return Token::EndOfFile();
+  }
+
+  if (impl.m_rewind.empty() && impl.m_cur != impl.m_lim) [[likely]] {
+    impl.ConsumeSpan(impl.m_kernels.m_skip_whitespace(impl.m_cur, impl.m_lim));
+  }
+
   uint8_t c;
   do {
     c = impl.NextChar();
   } while (kWhitespaceTable[c]);
 
+  if (impl.m_eof) [[unlikely]] {
+    return Token::EndOfFile();
+  }
+
   impl.m_parsing = true;
 
-  auto start_pos = InternLocation(Location(impl.m_offset, impl.m_line, impl.m_column, impl.m_filename));
+  auto start_pos = impl.m_offset < LocationID::kOffsetBit ? LocationID::FromOffset(impl.m_offset)
+                                                         : InternLocation(impl.Resolve(impl.m_offset));
 
   LexState state;
   if (kIdentiferStartTable[c]) {
@@ -1269,6 +1487,11 @@ auto Tokenizer::GetNext() -> Token {
       break;
   }
 
+  /* The input ended in the middle of the token */
+  if (impl.m_eof) [[unlikely]] {
+    token = Token::EndOfFile();
+  }
+
   if (token.Is(EofF)) [[unlikely]] {
     SetFailBit();
   }
@@ -1276,122 +1499,157 @@ auto Tokenizer::GetNext() -> Token {
   return token;
 }
 
+auto Tokenizer::GetLocationFallback(LocationID id) -> std::optional<Location> {
+  if (!id.IsOffset()) {
+    return std::nullopt;
+  }
+
+  return m_impl->Resolve(id.GetOffset());
+}
+
 Tokenizer::Tokenizer(std::istream &source_file, std::shared_ptr<IEnvironment> env)
     : IScanner(std::move(env)), m_impl(new Impl(source_file, [&]() { SetFailBit(); })) {}
 
-Tokenizer::Tokenizer(Tokenizer &&o) noexcept : IScanner(o.m_env), m_impl(std::move(o.m_impl)) {}
+Tokenizer::Tokenizer(std::string_view source, std::shared_ptr<IEnvironment> env)
+    : IScanner(std::move(env)), m_impl(new Impl(source, [&]() { SetFailBit(); })) {}
 
-Tokenizer::~Tokenizer() = default;
-
-auto Tokenizer::GetSourceWindow(Point start, Point end, char fillchar) -> std::optional<std::vector<std::string>> {
-  Impl &impl = *m_impl;
-
-  if (start.m_x > end.m_x || (start.m_x == end.m_x && start.m_y > end.m_y)) {
-    Log << "Invalid source window range";
-    return std::nullopt;
-  }
+Tokenizer::Tokenizer(std::shared_ptr<ISourceFile> source, std::shared_ptr<IEnvironment> env)
+    : Tokenizer(source->GetContent(), std::move(env)) {
+  m_impl->m_source_owner = std::move(source);
+}
 
-  impl.m_file.clear();
-  auto current_source_offset = impl.m_file.tellg();
-  if (!impl.m_file) {
-    Log << "Failed to get the current file offset";
-    return std::nullopt;
-  }
+Tokenizer::Tokenizer(Tokenizer &&o) noexcept : IScanner(o.m_env), m_impl(std::move(o.m_impl)) {}
 
-  if (impl.m_file.seekg(0, std::ios::beg)) {
-    long line = 0;
-    long column = 0;
+Tokenizer::~Tokenizer() = default;
 
-    bool spinning = true;
-    while (spinning) {
-      int ch = impl.m_file.get();
-      if (ch == EOF) [[unlikely]] {
-        break;
-      }
+template <typename GetChar>
+static auto ExtractSourceWindow(GetChar get, IScanner::Point start, IScanner::Point end,
+                                char fillchar) -> std::optional<std::vector<std::string>> {
+  long line = 0;
+  long column = 0;
 
-      bool is_begin = false;
-      if (line == start.m_x && column == start.m_y) [[unlikely]] {
-        is_begin = true;
-      } else {
-        switch (ch) {
-          case '\n': {
-            if (line == start.m_x && start.m_y == -1) [[unlikely]] {
-              is_begin = true;
-            }
+  bool spinning = true;
+  while (spinning) {
+    int ch = get();
+    if (ch == EOF) [[unlikely]] {
+      break;
+    }
 
-            line++;
-            column = 0;
-            break;
+    bool is_begin = false;
+    if (line == start.m_x && column == start.m_y) [[unlikely]] {
+      is_begin = true;
+    } else {
+      switch (ch) {
+        case '\n': {
+          if (line == start.m_x && start.m_y == -1) [[unlikely]] {
+            is_begin = true;
           }
 
-          default: {
-            column++;
-            break;
-          }
+          line++;
+          column = 0;
+          break;
+        }
+
+        default: {
+          column++;
+          break;
         }
       }
+    }
 
-      if (is_begin) [[unlikely]] {
-        std::vector<std::string> lines;
-        std::string line_buf;
+    if (is_begin) [[unlikely]] {
+      std::vector<std::string> lines;
+      std::string line_buf;
 
-        do {
-          long current_line = lines.size() + start.m_x;
-          long current_column = line_buf.size();
+      do {
+        long current_line = lines.size() + start.m_x;
+        long current_column = line_buf.size();
 
-          if (current_line == end.m_x && current_column == end.m_y) [[unlikely]] {
-            spinning = false;
-          } else {
-            switch (ch) {
-              case '\n': {
-                if (current_line == end.m_x && end.m_y == -1) [[unlikely]] {
-                  spinning = false;
-                }
-
-                lines.push_back(line_buf);
-                line_buf.clear();
-                break;
+        if (current_line == end.m_x && current_column == end.m_y) [[unlikely]] {
+          spinning = false;
+        } else {
+          switch (ch) {
+            case '\n': {
+              if (current_line == end.m_x && end.m_y == -1) [[unlikely]] {
+                spinning = false;
               }
 
-              default: {
-                line_buf.push_back(ch);
-                break;
-              }
+              lines.push_back(line_buf);
+              line_buf.clear();
+              break;
             }
-          }
 
-          ch = impl.m_file.get();
-          if (ch == EOF) [[unlikely]] {
-            spinning = false;
+            default: {
+              line_buf.push_back(ch);
+              break;
+            }
           }
-        } while (spinning);
-
-        if (!line_buf.empty()) {
-          lines.push_back(line_buf);
         }
 
-        size_t max_length = 0;
-        for (const auto &line : lines) {
-          max_length = std::max(max_length, line.size());
+        ch = get();
+        if (ch == EOF) [[unlikely]] {
+          spinning = false;
         }
+      } while (spinning);
 
-        for (auto &line : lines) {
-          if (line.size() < max_length) {
-            line.append(max_length - line.size(), fillchar);
-          }
-        }
+      if (!line_buf.empty()) {
+        lines.push_back(line_buf);
+      }
 
-        impl.m_file.seekg(current_source_offset);
-        return lines;
+      size_t max_length = 0;
+      for (const auto &line : lines) {
+        max_length = std::max(max_length, line.size());
       }
+
+      for (auto &line : lines) {
+        if (line.size() < max_length) {
+          line.append(max_length - line.size(), fillchar);
+        }
+      }
+
+      return lines;
     }
+  }
+
+  return std::nullopt;
+}
+
+auto Tokenizer::GetSourceWindow(Point start, Point end, char fillchar) -> std::optional<std::vector<std::string>> {
+  Impl &impl = *m_impl;
+
+  if (start.m_x > end.m_x || (start.m_x == end.m_x && start.m_y > end.m_y)) {
+    Log << "Invalid source window range";
+    return std::nullopt;
+  }
+
+  if (impl.IsContiguous()) {
+    size_t pos = 0;
+
+    return ExtractSourceWindow(
+        [&]() -> int { return pos < impl.m_source.size() ? static_cast<uint8_t>(impl.m_source[pos++]) : EOF; }, start,
+        end, fillchar);
+  }
+
+  auto &file = *impl.m_file;
+
+  file.clear();
+  auto current_source_offset = file.tellg();
+  if (!file) {
+    Log << "Failed to get the current file offset";
+    return std::nullopt;
+  }
+
+  std::optional<std::vector<std::string>> window;
+
+  if (file.seekg(0, std::ios::beg)) {
+    window = ExtractSourceWindow([&]() { return file.get(); }, start, end, fillchar);
   } else {
     Log << "Failed to seek to the beginning of the file";
   }
 
-  impl.m_file.seekg(current_source_offset);
+  file.seekg(current_source_offset);
 
-  return std::nullopt;
+  return window;
 }
 
 auto Tokenizer::SetCurrentFilename(string filename) -> string {
@@ -1401,3 +1659,5 @@ auto Tokenizer::SetCurrentFilename(string filename) -> string {
 }
 
 auto Tokenizer::GetCurrentFilename() -> string { return m_impl->m_filename; }
+
+auto Tokenizer::GetScanKernelName() -> std::string_view { return GetScanKernels().m_name; }
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <nitrate-core/Logger.hh>
+#include <nitrate-lexer/Lexer.hh>
+
+using namespace ncc;
+using namespace ncc::lex;
+
+MappedSourceFile::~MappedSourceFile() {
+  if (m_base != nullptr) {
+    munmap(m_base, m_size);
+  }
+}
+
+auto MappedSourceFile::Open(const std::string &path) -> std::shared_ptr<MappedSourceFile> {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    Log << "Failed to open source file: " << path << ": " << GetStrerror();
+    return nullptr;
+  }
+
+  struct stat st = {};
+  if (fstat(fd, &st) != 0) {
+    Log << "Failed to stat source file: " << path << ": " << GetStrerror();
+    close(fd);
+    return nullptr;
+  }
+
+  const auto size = static_cast<size_t>(st.st_size);
+
+  /* Zero-length mappings are not permitted */
+  void *base = nullptr;
+  if (size != 0) {
+    base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+      Log << "Failed to map source file: " << path << ": " << GetStrerror();
+      close(fd);
+      return nullptr;
+    }
+
+    /* The tokenizer reads front to back exactly once */
+    (void)madvise(base, size, MADV_SEQUENTIAL);
+  }
+
+  close(fd);
+
+  return std::shared_ptr<MappedSourceFile>(new MappedSourceFile(base, size));
+}
+
+auto MappedSourceFile::GetContent() const -> std::string_view {
+  return {static_cast<const char *>(m_base), m_size};
+}
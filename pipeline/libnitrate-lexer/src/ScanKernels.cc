@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "ScanKernels.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NCC_LEXER_X86_KERNELS 1
+#else
+#define NCC_LEXER_X86_KERNELS 0
+#endif
+
+using namespace ncc::lex::detail;
+
+///============================================================================///
+/// SCALAR
+
+static auto ScalarSkipWhitespace(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  while (p != end && kWhitespaceTable[*p]) {
+    p++;
+  }
+
+  return p;
+}
+
+static auto ScalarFindIdentifierEnd(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  while (p != end && kIdentifierCharTable[*p]) {
+    p++;
+  }
+
+  return p;
+}
+
+template <uint8_t Quote>
+static auto ScalarFindQuoteOrEscape(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  while (p != end && *p != Quote && *p != '\\') {
+    p++;
+  }
+
+  return p;
+}
+
+static auto ScalarCountNewlines(const uint8_t *p, const uint8_t *end) -> size_t { return std::count(p, end, '\n'); }
+
+#if NCC_LEXER_X86_KERNELS
+
+///============================================================================///
+/// SSE4.2
+
+/* Inclusive byte ranges for PCMPESTRI, one pair per range */
+alignas(16) static constexpr char kIdentifierRanges[16] = {'a', 'z', 'A', 'Z', '0', '9', '_', '_', '\x80', '\xfe'};
+static constexpr int kIdentifierRangesLen = 10;
+
+alignas(16) static constexpr char kWhitespaceRanges[16] = {'\0', '\0', '\t', '\r', ' ', ' ', '\\', '\\'};
+static constexpr int kWhitespaceRangesLen = 8;
+
+/* Advance `p` over whole blocks inside the ranges; true if it stopped on a byte outside them */
+[[gnu::target("sse4.2")]] static auto Sse42SkipRanges(const uint8_t *&p, const uint8_t *end, const char *ranges,
+                                                      int ranges_len) -> bool {
+  const auto set = _mm_load_si128(reinterpret_cast<const __m128i *>(ranges));
+
+  while (end - p >= 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const int idx = _mm_cmpestri(set, ranges_len, block, 16,
+                                 _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+    if (idx != 16) {
+      p += idx;
+      return true;
+    }
+
+    p += 16;
+  }
+
+  return false;
+}
+
+[[gnu::target("sse4.2")]] static auto Sse42SkipWhitespace(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  if (Sse42SkipRanges(p, end, kWhitespaceRanges, kWhitespaceRangesLen)) {
+    return p;
+  }
+
+  return ScalarSkipWhitespace(p, end);
+}
+
+[[gnu::target("sse4.2")]] static auto Sse42FindIdentifierEnd(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  if (Sse42SkipRanges(p, end, kIdentifierRanges, kIdentifierRangesLen)) {
+    return p;
+  }
+
+  return ScalarFindIdentifierEnd(p, end);
+}
+
+template <uint8_t Quote>
+[[gnu::target("sse4.2")]] static auto Sse42FindQuoteOrEscape(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  const auto set = _mm_setr_epi8(Quote, '\\', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+  while (end - p >= 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    const int idx = _mm_cmpestri(set, 2, block, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+    if (idx != 16) {
+      return p + idx;
+    }
+
+    p += 16;
+  }
+
+  return ScalarFindQuoteOrEscape<Quote>(p, end);
+}
+
+[[gnu::target("sse4.2,popcnt")]] static auto Sse42CountNewlines(const uint8_t *p, const uint8_t *end) -> size_t {
+  const auto newline = _mm_set1_epi8('\n');
+  size_t count = 0;
+
+  while (end - p >= 16) {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    count += _mm_popcnt_u32(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+    p += 16;
+  }
+
+  return count + ScalarCountNewlines(p, end);
+}
+
+///============================================================================///
+/// AVX2
+
+/* Bytes of `x` in the inclusive range [lo, hi], compared as unsigned */
+[[gnu::target("avx2"), gnu::always_inline]] static inline auto Avx2InRange(__m256i x, uint8_t lo, uint8_t hi)
+    -> __m256i {
+  const auto d = _mm256_sub_epi8(x, _mm256_set1_epi8(static_cast<char>(lo)));
+  return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(static_cast<char>(hi - lo))), d);
+}
+
+/* Index of the first zero bit of a 32-lane byte mask, or 32 */
+[[gnu::always_inline]] static inline auto FirstClear(int mask) -> unsigned {
+  const auto inverted = ~static_cast<uint32_t>(mask);
+  return inverted == 0 ? 32 : __builtin_ctz(inverted);
+}
+
+[[gnu::target("avx2")]] static auto Avx2SkipWhitespace(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  while (end - p >= 32) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    const auto ws = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_setzero_si256()), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' '))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')), Avx2InRange(x, '\t', '\r')));
+
+    if (const auto idx = FirstClear(_mm256_movemask_epi8(ws)); idx != 32) {
+      return p + idx;
+    }
+
+    p += 32;
+  }
+
+  return ScalarSkipWhitespace(p, end);
+}
+
+[[gnu::target("avx2")]] static auto Avx2FindIdentifierEnd(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  while (end - p >= 32) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+
+    /* Folding case with |0x20 maps only 'A'-'Z' onto 'a'-'z' */
+    const auto alpha = Avx2InRange(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z');
+    const auto ident = _mm256_or_si256(
+        _mm256_or_si256(alpha, Avx2InRange(x, '0', '9')),
+        _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')), Avx2InRange(x, 0x80, 0xfe)));
+
+    if (const auto idx = FirstClear(_mm256_movemask_epi8(ident)); idx != 32) {
+      return p + idx;
+    }
+
+    p += 32;
+  }
+
+  return ScalarFindIdentifierEnd(p, end);
+}
+
+template <uint8_t Quote>
+[[gnu::target("avx2")]] static auto Avx2FindQuoteOrEscape(const uint8_t *p, const uint8_t *end) -> const uint8_t * {
+  const auto quote = _mm256_set1_epi8(static_cast<char>(Quote));
+  const auto escape = _mm256_set1_epi8('\\');
+
+  while (end - p >= 32) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    const auto hits = _mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, escape));
+
+    if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)); mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+
+    p += 32;
+  }
+
+  return ScalarFindQuoteOrEscape<Quote>(p, end);
+}
+
+[[gnu::target("avx2,popcnt")]] static auto Avx2CountNewlines(const uint8_t *p, const uint8_t *end) -> size_t {
+  const auto newline = _mm256_set1_epi8('\n');
+  size_t count = 0;
+
+  while (end - p >= 32) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    count += _mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, newline))));
+    p += 32;
+  }
+
+  return count + ScalarCountNewlines(p, end);
+}
+
+#endif
+
+///============================================================================///
+/// DISPATCH
+
+static constexpr ScanKernels kScalarKernels = {
+    "scalar",
+    ScalarSkipWhitespace,
+    ScalarFindIdentifierEnd,
+    ScalarFindQuoteOrEscape<'"'>,
+    ScalarFindQuoteOrEscape<'\''>,
+    ScalarCountNewlines,
+};
+
+#if NCC_LEXER_X86_KERNELS
+static constexpr ScanKernels kSse42Kernels = {
+    "sse4.2",
+    Sse42SkipWhitespace,
+    Sse42FindIdentifierEnd,
+    Sse42FindQuoteOrEscape<'"'>,
+    Sse42FindQuoteOrEscape<'\''>,
+    Sse42CountNewlines,
+};
+
+static constexpr ScanKernels kAvx2Kernels = {
+    "avx2",
+    Avx2SkipWhitespace,
+    Avx2FindIdentifierEnd,
+    Avx2FindQuoteOrEscape<'"'>,
+    Avx2FindQuoteOrEscape<'\''>,
+    Avx2CountNewlines,
+};
+#endif
+
+static auto SelectScanKernels() -> const ScanKernels & {
+#if NCC_LEXER_X86_KERNELS
+  std::string_view cap = "avx2";
+  if (const char *env = std::getenv("NCC_LEXER_KERNELS")) {  // NOLINT(concurrency-mt-unsafe)
+    cap = env;
+  }
+
+  __builtin_cpu_init();
+
+  const bool popcnt = __builtin_cpu_supports("popcnt");
+
+  if (cap == kAvx2Kernels.m_name && popcnt && __builtin_cpu_supports("avx2")) {
+    return kAvx2Kernels;
+  }
+
+  if ((cap == kAvx2Kernels.m_name || cap == kSse42Kernels.m_name) && popcnt && __builtin_cpu_supports("sse4.2")) {
+    return kSse42Kernels;
+  }
+#endif
+
+  return kScalarKernels;
+}
+
+auto ncc::lex::detail::GetSupportedScanKernels() -> std::vector<const ScanKernels *> {
+  std::vector<const ScanKernels *> kernels = {&kScalarKernels};
+
+#if NCC_LEXER_X86_KERNELS
+  __builtin_cpu_init();
+
+  const bool popcnt = __builtin_cpu_supports("popcnt");
+
+  if (popcnt && __builtin_cpu_supports("sse4.2")) {
+    kernels.push_back(&kSse42Kernels);
+  }
+
+  if (popcnt && __builtin_cpu_supports("avx2")) {
+    kernels.push_back(&kAvx2Kernels);
+  }
+#endif
+
+  return kernels;
+}
+
+auto ncc::lex::detail::GetScanKernels() -> const ScanKernels & {
+  static const ScanKernels &kernels = SelectScanKernels();
+  return kernels;
+}
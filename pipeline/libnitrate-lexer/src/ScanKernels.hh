@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NITRATE_LEXER_SCAN_KERNELS_H__
+#define __NITRATE_LEXER_SCAN_KERNELS_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <nitrate-core/Macro.hh>
+#include <string_view>
+#include <vector>
+
+namespace ncc::lex::detail {
+  inline constexpr auto kWhitespaceTable = []() {
+    std::array<bool, 256> tab = {};
+
+    tab[' '] = true;
+    tab['\f'] = true;
+    tab['\n'] = true;
+    tab['\r'] = true;
+    tab['\t'] = true;
+    tab['\v'] = true;
+    tab['\\'] = true;
+    tab['\0'] = true;  // Null byte is also a whitespace character
+
+    return tab;
+  }();
+
+  inline constexpr auto kIdentifierCharTable = []() {
+    std::array<bool, 256> tab = {};
+
+    for (uint8_t c = 'a'; c <= 'z'; ++c) {
+      tab[c] = true;
+    }
+
+    for (uint8_t c = 'A'; c <= 'Z'; ++c) {
+      tab[c] = true;
+    }
+
+    for (uint8_t c = '0'; c <= '9'; ++c) {
+      tab[c] = true;
+    }
+
+    tab['_'] = true;
+
+    /* Support UTF-8 */
+    for (uint8_t c = 0x80; c < 0xff; c++) {
+      tab[c] = true;
+    }
+
+    return tab;
+  }();
+
+  /**
+   * Bulk byte classifiers used by the tokenizer to skip over runs of input
+   * without stepping through NextChar(). Every search kernel returns the
+   * address of the first byte in [begin, end) that stops the run, or `end`.
+   */
+  struct ScanKernels {
+    using Search = const uint8_t *(*)(const uint8_t *begin, const uint8_t *end);
+
+    std::string_view m_name;
+
+    /** First byte that is not whitespace */
+    Search m_skip_whitespace;
+
+    /** First byte that cannot continue an identifier */
+    Search m_find_identifier_end;
+
+    /** First double quote or backslash */
+    Search m_find_dquote_or_escape;
+
+    /** First single quote or backslash */
+    Search m_find_squote_or_escape;
+
+    /** Number of '\n' bytes in the range */
+    size_t (*m_count_newlines)(const uint8_t *begin, const uint8_t *end);
+  };
+
+  /**
+   * The best kernel set supported by the host CPU, chosen once. Setting
+   * NCC_LEXER_KERNELS to "scalar", "sse4.2" or "avx2" caps the selection.
+   */
+  NCC_EXPORT auto GetScanKernels() -> const ScanKernels &;
+
+  /** Every kernel set the host CPU can run, starting with the scalar reference */
+  NCC_EXPORT auto GetSupportedScanKernels() -> std::vector<const ScanKernels *>;
+}  // namespace ncc::lex::detail
+
+#endif
@@ -32,7 +32,6 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <nitrate-core/Environment.hh>
 #include <nitrate-core/Logger.hh>
@@ -40,13 +39,68 @@
 #include <nitrate-core/Testing.hh>
 #include <nitrate-lexer/Scanner.hh>
 #include <nitrate-lexer/Token.hh>
+#include <vector>
 
 using namespace ncc::lex;
-using namespace ncc::lex::detail;
+
+namespace {
+  /**
+   * Lookahead queue with power-of-two capacity. The parser only ever looks a
+   * handful of tokens ahead, so the initial storage is never reallocated in
+   * practice; it only grows when a caller inserts or peeks unusually far.
+   */
+  class TokenRing {
+    static constexpr size_t kInitialCapacity = 16;
+
+    std::vector<Token> m_storage = std::vector<Token>(kInitialCapacity);
+    size_t m_head = 0, m_size = 0;
+
+    [[nodiscard]] auto Mask() const -> size_t { return m_storage.size() - 1; }
+
+    auto Grow() -> void {
+      std::vector<Token> storage(m_storage.size() * 2);
+      for (size_t i = 0; i < m_size; ++i) {
+        storage[i] = (*this)[i];
+      }
+
+      m_storage = std::move(storage);
+      m_head = 0;
+    }
+
+  public:
+    [[nodiscard]] auto Empty() const -> bool { return m_size == 0; }
+    [[nodiscard]] auto Size() const -> size_t { return m_size; }
+    [[nodiscard]] auto operator[](size_t i) const -> Token { return m_storage[(m_head + i) & Mask()]; }
+    [[nodiscard]] auto Front() const -> Token { return m_storage[m_head]; }
+
+    auto PopFront() -> void {
+      m_head = (m_head + 1) & Mask();
+      --m_size;
+    }
+
+    auto PushBack(Token tok) -> void {
+      if (m_size == m_storage.size()) [[unlikely]] {
+        Grow();
+      }
+
+      m_storage[(m_head + m_size++) & Mask()] = tok;
+    }
+
+    auto PushFront(Token tok) -> void {
+      if (m_size == m_storage.size()) [[unlikely]] {
+        Grow();
+      }
+
+      m_head = (m_head - 1) & Mask();
+      m_storage[m_head] = tok;
+      ++m_size;
+    }
+  };
+}  // namespace
 
 class IScanner::PImpl {
 public:
-  std::deque<Token> m_ready;
+  TokenRing m_ready;
   std::vector<Token> m_comments;
   std::vector<Location> m_location_interned;
   Token m_current;
@@ -56,9 +110,8 @@ public:
 auto IScanner::GetLocationFallback(LocationID) -> std::optional<Location> { return std::nullopt; };
 
 IScanner::IScanner(std::shared_ptr<IEnvironment> env) : m_impl(std::make_unique<PImpl>()), m_env(std::move(env)) {
-  constexpr size_t kInitialLocationReserve = 0xffff;
-
-  m_impl->m_location_interned.reserve(kInitialLocationReserve);
+  /* Scanners that know their source hand out offset-based LocationIDs, so only
+   * explicitly interned locations (e.g. from a deserialized AST) land here. */
   m_impl->m_location_interned.emplace_back(Location::EndOfFile());
 }
 
@@ -85,25 +138,21 @@ auto IScanner::Next() -> Token {
   Token tok;
   PImpl &m = *m_impl;
 
-  try {
-    while (true) {
-      if (m.m_ready.empty()) {
-        tok = GetNext();
-      } else {
-        tok = m.m_ready.front();
-        m.m_ready.pop_front();
-      }
-
-      /* Handle comment token buffering */
-      if (m.m_skip && tok.Is(Note)) [[unlikely]] {
-        m.m_comments.push_back(tok);
-        continue;
-      }
+  while (true) {
+    if (m.m_ready.Empty()) {
+      tok = GetNext();
+    } else {
+      tok = m.m_ready.Front();
+      m.m_ready.PopFront();
+    }
 
-      break;
+    /* Handle comment token buffering */
+    if (m.m_skip && tok.Is(Note)) [[unlikely]] {
+      m.m_comments.push_back(tok);
+      continue;
     }
-  } catch (ScannerEOF &) { /* EOF signal optimization */
-    tok = Token::EndOfFile();
+
+    break;
   }
 
   m.m_eof |= tok.Is(EofF);
@@ -116,25 +165,21 @@ auto IScanner::Peek() -> Token {
   Token tok;
   PImpl &m = *m_impl;
 
-  try {
-    while (true) {
-      if (m.m_ready.empty()) {
-        m.m_ready.push_back(GetNext());
-      }
-
-      tok = m.m_ready.front();
+  while (true) {
+    if (m.m_ready.Empty()) {
+      m.m_ready.PushBack(GetNext());
+    }
 
-      /* Handle comment token buffering */
-      if (m.m_skip && tok.Is(Note)) [[unlikely]] {
-        m.m_comments.push_back(tok);
-        m.m_ready.pop_front();
-        continue;
-      }
+    tok = m.m_ready.Front();
 
-      break;
+    /* Handle comment token buffering */
+    if (m.m_skip && tok.Is(Note)) [[unlikely]] {
+      m.m_comments.push_back(tok);
+      m.m_ready.PopFront();
+      continue;
     }
-  } catch (ScannerEOF &) { /* EOF signal optimization */
-    tok = Token::EndOfFile();
+
+    break;
   }
 
   m.m_eof |= tok.Is(EofF);
@@ -143,9 +188,38 @@ auto IScanner::Peek() -> Token {
   return tok;
 }
 
+auto IScanner::Peek(size_t n) -> Token {
+  if (n == 0) {
+    return Peek();
+  }
+
+  PImpl &m = *m_impl;
+
+  /* Drain leading comments exactly like Peek() so the comment buffer keeps
+   * the order in which tokens are consumed. */
+  auto tok = Peek();
+
+  for (size_t i = 1; n > 0; ++i) {
+    if (i == m.m_ready.Size()) {
+      if (tok.Is(EofF)) [[unlikely]] {
+        return tok;
+      }
+
+      m.m_ready.PushBack(GetNext());
+    }
+
+    tok = m.m_ready[i];
+    if (!m.m_skip || !tok.Is(Note)) [[likely]] {
+      --n;
+    }
+  }
+
+  return tok;
+}
+
 auto IScanner::Insert(Token tok) -> void {
   PImpl &m = *m_impl;
-  m.m_ready.push_front(tok);
+  m.m_ready.PushFront(tok);
   m.m_current = tok;
 }
 
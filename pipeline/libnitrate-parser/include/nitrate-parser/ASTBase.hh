@@ -35,6 +35,7 @@
 #define __NITRATE_AST_BASE_H__
 
 #include <array>
+#include <memory_resource>
 #include <mutex>
 #include <nitrate-core/FlowPtr.hh>
 #include <nitrate-core/Macro.hh>
@@ -43,6 +44,7 @@
 #include <nitrate-lexer/ScannerFwd.hh>
 #include <nitrate-parser/AST.hh>
 #include <nitrate-parser/ASTVisitor.hh>
+#include <span>
 #include <type_traits>
 #include <utility>
 
@@ -60,43 +62,61 @@ namespace ncc::parse {
     [[nodiscard]] constexpr auto Key() const { return m_key; }
   } __attribute__((packed));
 
+  /**
+   * Locations and comments of AST and IR nodes. Records are allocated from the
+   * memory resource that owns the nodes, so they are freed with the tree; the
+   * key is the address of the record. Nodes created outside of an
+   * ASTExtensionScope fall back to a process-wide store.
+   */
   class NCC_EXPORT ASTExtension {
     class ASTExtensionPackage {
       friend class ASTExtension;
 
       lex::LocationID m_begin;
       lex::LocationID m_end;
-      std::vector<string> m_comments;
+      std::span<const string> m_comments;
+      std::pmr::memory_resource *m_pool;
 
-      ASTExtensionPackage(lex::LocationID begin, lex::LocationID end) : m_begin(begin), m_end(end) {}
+      ASTExtensionPackage(lex::LocationID begin, lex::LocationID end, std::pmr::memory_resource *pool)
+          : m_begin(begin), m_end(end), m_pool(pool) {}
 
     public:
       [[nodiscard]] auto Begin() const { return m_begin; }
       [[nodiscard]] auto End() const { return m_end; }
       [[nodiscard]] auto Comments() const -> std::span<const string> { return m_comments; }
-
-      void AddComments(std::span<const string> comments) {
-        m_comments.insert(m_comments.end(), comments.begin(), comments.end());
-      }
     };
 
-    std::vector<ASTExtensionPackage> m_pairs;
+    ASTExtensionPackage m_empty = {lex::LocationID(), lex::LocationID(), nullptr};
+    std::pmr::monotonic_buffer_resource m_fallback;
     std::mutex m_mutex;
 
+    auto Allocate(std::pmr::memory_resource &pool, size_t size, size_t align) -> void *;
+    auto Create(lex::LocationID begin, lex::LocationID end, std::pmr::memory_resource &pool) -> ASTExtensionKey;
+
   public:
-    ASTExtension() { Reset(); }
+    ASTExtension() = default;
 
-    void Reset() {
-      m_pairs.clear();
-      m_pairs.shrink_to_fit();
-      m_pairs.reserve(4096);
+    /* Frees the records of the fallback store */
+    void Reset();
+
+    auto Add(lex::LocationID begin, lex::LocationID end) -> ASTExtensionKey;
+    auto Add(lex::LocationID begin, lex::LocationID end, std::pmr::memory_resource &pool) -> ASTExtensionKey;
+    void AddComments(ASTExtensionKey &id, std::span<const string> comments);
 
-      m_pairs.push_back({lex::LocationID(), lex::LocationID()});
+    [[nodiscard]] auto Get(ASTExtensionKey loc) const -> const ASTExtensionPackage & {
+      return loc.IsNull() ? m_empty : *reinterpret_cast<const ASTExtensionPackage *>(loc.Key());
     }
+  };
 
-    auto Add(lex::LocationID begin, lex::LocationID end) -> ASTExtensionKey;
-    auto Get(ASTExtensionKey loc) -> const ASTExtensionPackage &;
-    void Set(ASTExtensionKey id, ASTExtensionPackage &&data);
+  /** While alive, extension records of nodes created on this thread are
+   * allocated from the given resource. Scopes nest. */
+  class NCC_EXPORT ASTExtensionScope final {
+    std::pmr::memory_resource *m_previous;
+
+  public:
+    explicit ASTExtensionScope(std::pmr::memory_resource &pool);
+    ASTExtensionScope(const ASTExtensionScope &) = delete;
+    ~ASTExtensionScope();
   };
 
   auto operator<<(std::ostream &os, const ASTExtensionKey &idx) -> std::ostream &;
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NITRATE_AST_FLAT_H__
+#define __NITRATE_AST_FLAT_H__
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <nitrate-core/Macro.hh>
+#include <nitrate-core/NullableFlowPtr.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+namespace ncc::parse {
+  /**
+   * The flat format is a position independent image of a syntax tree that can
+   * be mapped into memory and traversed in place:
+   *
+   *   | header | node records | string table |
+   *
+   * A node record is a run of little-endian 32-bit words: the head word (kind,
+   * flags and a 16-bit scalar such as the operator), the slot count, the
+   * comment count, the slots and then one string id per comment. A slot is
+   * tagged in its low two bits; a node slot holds the distance in words back
+   * to the child record. Children are written before their parents, so the
+   * root is the last record. Source locations are relative to the scanner
+   * that produced the tree and are not encoded.
+   */
+  namespace flat {
+    static constexpr std::array<char, 4> kMagic = {'N', 'A', 'S', 'T'};
+    static constexpr uint32_t kVersion = 1;
+
+    enum class Slot : uint8_t { Null = 0, Node = 1, String = 2, Value = 3 };
+    enum Flags : uint8_t { kMock = 1 << 0 };
+
+    struct Header {
+      std::array<char, 4> m_magic;
+      uint32_t m_version;
+      uint32_t m_nodes_size;  /* Size of the node section in bytes */
+      uint32_t m_root;        /* Offset of the root record in the node section */
+      uint32_t m_string_size; /* Size of the string table in bytes */
+      uint32_t m_reserved;
+    };
+
+    static_assert(sizeof(Header) == 24);
+
+    [[nodiscard]] static inline auto LoadWord(const char *p) -> uint32_t {
+      uint32_t word;
+      std::memcpy(&word, p, sizeof(word));
+      return word;
+    }
+  }  // namespace flat
+
+  /** A record of a flat tree, read in place. Valid while the buffer lives. */
+  class FlatNode final {
+    friend class FlatAst;
+
+    const char *m_nodes;
+    const char *m_strings;
+    uint32_t m_offset;
+
+    constexpr FlatNode(const char *nodes, const char *strings, uint32_t offset)
+        : m_nodes(nodes), m_strings(strings), m_offset(offset) {}
+
+    [[nodiscard]] auto Word(uint32_t i) const -> uint32_t { return flat::LoadWord(m_nodes + m_offset + i * 4); }
+    [[nodiscard]] auto Slot(uint32_t i) const -> uint32_t { return Word(3 + i); }
+
+    [[nodiscard]] auto String(uint32_t id) const -> std::string_view {
+      auto begin = flat::LoadWord(m_strings + 4 + id * 4);
+      auto end = flat::LoadWord(m_strings + 8 + id * 4);
+      auto count = flat::LoadWord(m_strings);
+      return {m_strings + 8 + count * 4 + begin, end - begin};
+    }
+
+  public:
+    [[nodiscard]] auto GetKind() const -> ASTNodeKind { return static_cast<ASTNodeKind>(Word(0) & 0xff); }
+    [[nodiscard]] auto IsMock() const -> bool { return ((Word(0) >> 8) & flat::kMock) != 0; }
+    [[nodiscard]] auto GetScalar() const -> uint16_t { return Word(0) >> 16; }
+    [[nodiscard]] auto GetOffset() const -> uint32_t { return m_offset; }
+
+    /* Number of words in the record */
+    [[nodiscard]] auto GetSize() const -> uint32_t { return 3 + Word(1) + Word(2); }
+
+    [[nodiscard]] auto SlotCount() const -> uint32_t { return Word(1); }
+    [[nodiscard]] auto GetSlotKind(uint32_t i) const -> flat::Slot { return static_cast<flat::Slot>(Slot(i) & 3); }
+    [[nodiscard]] auto GetNode(uint32_t i) const -> FlatNode {
+      return {m_nodes, m_strings, m_offset - (Slot(i) >> 2) * 4};
+    }
+    [[nodiscard]] auto GetString(uint32_t i) const -> std::string_view { return String(Slot(i) >> 2); }
+    [[nodiscard]] auto GetStringId(uint32_t i) const -> uint32_t { return Slot(i) >> 2; }
+    [[nodiscard]] auto GetValue(uint32_t i) const -> uint32_t { return Slot(i) >> 2; }
+
+    [[nodiscard]] auto CommentCount() const -> uint32_t { return Word(2); }
+    [[nodiscard]] auto GetCommentId(uint32_t i) const -> uint32_t { return Word(3 + Word(1) + i); }
+    [[nodiscard]] auto GetComment(uint32_t i) const -> std::string_view { return String(GetCommentId(i)); }
+
+    template <typename Fn>
+    void ForEachChild(Fn &&fn) const {
+      for (uint32_t i = 0, n = SlotCount(); i < n; ++i) {
+        if (GetSlotKind(i) == flat::Slot::Node) {
+          fn(GetNode(i));
+        }
+      }
+    }
+  };
+
+  /**
+   * A validated view of a flat tree. Open() checks the header, every record
+   * and every string reference once; afterwards nodes are read without
+   * further checks and without copying the buffer.
+   */
+  class NCC_EXPORT FlatAst final {
+    const char *m_nodes = nullptr;
+    const char *m_strings = nullptr;
+    uint32_t m_nodes_size = 0;
+    uint32_t m_root = 0;
+
+  public:
+    [[nodiscard]] static auto Open(std::string_view data) -> std::optional<FlatAst>;
+
+    [[nodiscard]] auto Root() const -> FlatNode { return {m_nodes, m_strings, m_root}; }
+
+    /* The record at a byte offset of the node section; records follow each
+     * other, so the next one starts GetSize() words later. */
+    [[nodiscard]] auto At(uint32_t offset) const -> FlatNode { return {m_nodes, m_strings, offset}; }
+    [[nodiscard]] auto NodesSize() const -> uint32_t { return m_nodes_size; }
+    [[nodiscard]] auto StringCount() const -> uint32_t { return flat::LoadWord(m_strings); }
+    [[nodiscard]] auto GetString(uint32_t id) const -> std::string_view { return Root().String(id); }
+  };
+
+  class NCC_EXPORT FlatAstWriter final {
+    std::ostream &m_os;
+
+  public:
+    FlatAstWriter(std::ostream &os) : m_os(os) {}
+
+    void Write(const FlowPtr<Expr> &root);
+  };
+
+  class NCC_EXPORT FlatAstReader final {
+    NullableFlowPtr<Expr> m_root;
+
+  public:
+    FlatAstReader(std::string_view flat_data, std::pmr::memory_resource &pool);
+    ~FlatAstReader() = default;
+
+    auto Get() -> NullableFlowPtr<Expr>;
+  };
+}  // namespace ncc::parse
+
+#endif
@@ -42,6 +42,7 @@
 #include <nitrate-parser/ASTFactory.hh>
 #include <nitrate-parser/Context.hh>
 #include <nitrate-parser/ProtobufFwd.hh>
+#include <istream>
 #include <optional>
 
 namespace ncc::parse {
@@ -133,6 +134,12 @@ namespace ncc::parse {
   public:
     AstReader(std::string_view protobuf_data, std::pmr::memory_resource &pool,
               ReaderSourceManager source_manager = std::nullopt);
+
+    /** Decodes the stream one top-level field at a time. The statements of a
+     * root block are unmarshalled as their fields arrive, so only one of them
+     * is held in encoded form. */
+    AstReader(std::istream &protobuf_stream, std::pmr::memory_resource &pool,
+              ReaderSourceManager source_manager = std::nullopt);
     ~AstReader() = default;
 
     auto Get() -> NullableFlowPtr<Expr>;
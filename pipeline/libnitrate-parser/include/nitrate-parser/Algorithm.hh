@@ -34,8 +34,13 @@
 #ifndef __NITRATE_AST_ALGORITHM_H__
 #define __NITRATE_AST_ALGORITHM_H__
 
+#include <algorithm>
+#include <boost/container/small_vector.hpp>
 #include <functional>
+#include <nitrate-core/Assert.hh>
 #include <nitrate-parser/ASTBase.hh>
+#include <type_traits>
+#include <utility>
 
 namespace ncc::parse {
   enum IterMode : uint8_t {
@@ -55,51 +60,220 @@ namespace ncc::parse {
   using IterCallback = std::function<IterOp(NullableFlowPtr<Expr>, FlowPtr<Expr>)>;
 
   namespace detail {
-    void DfsPreImpl(const FlowPtr<Expr> &base, const IterCallback &cb);
-    void DfsPostImpl(const FlowPtr<Expr> &base, const IterCallback &cb);
-    void BfsPreImpl(const FlowPtr<Expr> &base, const IterCallback &cb);
-    void BfsPostImpl(const FlowPtr<Expr> &base, const IterCallback &cb);
-    void IterChildren(const FlowPtr<Expr> &base, const IterCallback &cb);
+    using ChildList = boost::container::small_vector_base<FlowPtr<Expr>>;
+
+    /** Appends the non-null children of a node in source order. */
+    void GetChildren(const FlowPtr<Expr> &base, ChildList &children);
+
+    /**
+     * The traversals below are templates over the callback, so the callback
+     * is inlined into the loop. The work lists live on the stack until a tree
+     * is deeper or wider than their inline capacity.
+     */
+    constexpr size_t kInlineChildren = 16;
+    constexpr size_t kInlineFrames = 64;
+
+    using Children = boost::container::small_vector<FlowPtr<Expr>, kInlineChildren>;
+    using Edge = std::pair<NullableFlowPtr<Expr>, FlowPtr<Expr>>;
+
+    template <typename Fn, typename... Args>
+    constexpr auto Invoke(Fn &cb, Args &&...args) -> IterOp {
+      if constexpr (std::is_same_v<std::invoke_result_t<Fn &, Args...>, IterOp>) {
+        return cb(std::forward<Args>(args)...);
+      } else {
+        cb(std::forward<Args>(args)...);
+        return IterOp::Proceed;
+      }
+    }
+
+    /**
+     * Children are appended straight onto the node stack and reversed in
+     * place. Parents are only tracked when the callback takes them.
+     */
+    template <bool kParents, typename Fn>
+    void DfsPre(const FlowPtr<Expr> &base, Fn &cb) {
+      boost::container::small_vector<FlowPtr<Expr>, kInlineFrames> nodes;
+      boost::container::small_vector<NullableFlowPtr<Expr>, kInlineFrames> parents;
+
+      nodes.push_back(base);
+      if constexpr (kParents) {
+        parents.emplace_back(nullptr);
+      }
+
+      while (!nodes.empty()) {
+        const auto node = nodes.back();
+        nodes.pop_back();
+
+        IterOp op;
+        if constexpr (kParents) {
+          const auto parent = parents.back();
+          parents.pop_back();
+          op = Invoke(cb, parent, node);
+        } else {
+          op = Invoke(cb, node);
+        }
+
+        switch (op) {
+          case IterOp::Proceed: {
+            break;
+          }
+
+          case IterOp::Abort:
+            [[unlikely]] { return; }
+
+          case IterOp::SkipChildren: {
+            continue;
+          }
+        }
+
+        const auto first = nodes.size();
+        GetChildren(node, nodes);
+        std::reverse(nodes.begin() + first, nodes.end());
+
+        if constexpr (kParents) {
+          parents.resize(nodes.size(), node);
+        }
+      }
+    }
+
+    template <typename Fn>
+    void DfsPost(const FlowPtr<Expr> &base, Fn &cb) {
+      struct Frame {
+        Edge m_edge;
+        bool m_expanded;
+      };
+
+      boost::container::small_vector<Frame, kInlineFrames> stack;
+      Children children;
+
+      stack.push_back({{nullptr, base}, false});
+
+      while (!stack.empty()) {
+        if (!stack.back().m_expanded) {
+          stack.back().m_expanded = true;
+          const auto node = stack.back().m_edge.second;
+
+          children.clear();
+          GetChildren(node, children);
+          for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back({{node, *it}, false});
+          }
+
+          continue;
+        }
+
+        auto [parent, node] = stack.back().m_edge;
+        stack.pop_back();
+
+        switch (Invoke(cb, parent, node)) {
+          case IterOp::Proceed: {
+            break;
+          }
+
+          case IterOp::Abort:
+            [[unlikely]] { return; }
+
+          case IterOp::SkipChildren: {
+            qcore_panic("dfs_post: IterOp::SkipChildren not supported");
+          }
+        }
+      }
+    }
+
+    template <bool kPost, typename Fn>
+    void Bfs(const FlowPtr<Expr> &base, Fn &cb) {
+      boost::container::small_vector<Edge, kInlineFrames> queue;
+      Children children;
+
+      queue.emplace_back(nullptr, base);
+
+      for (size_t head = 0; head < queue.size(); ++head) {
+        auto [parent, node] = queue[head];
+
+        if constexpr (kPost) {
+          children.clear();
+          GetChildren(node, children);
+        }
+
+        switch (Invoke(cb, parent, node)) {
+          case IterOp::Proceed: {
+            break;
+          }
+
+          case IterOp::Abort:
+            [[unlikely]] { return; }
+
+          case IterOp::SkipChildren: {
+            if constexpr (kPost) {
+              qcore_panic("bfs_post: IterOp::SkipChildren not supported");
+            }
+
+            continue;
+          }
+        }
+
+        if constexpr (!kPost) {
+          children.clear();
+          GetChildren(node, children);
+        }
+
+        for (const auto &child : children) {
+          queue.emplace_back(node, child);
+        }
+      }
+    }
+
+    template <typename Fn>
+    void IterChildren(const FlowPtr<Expr> &base, Fn &cb) {
+      Children children;
+      GetChildren(base, children);
+
+      for (const auto &child : children) {
+        if (Invoke(cb, NullableFlowPtr<Expr>(base), child) != IterOp::Proceed) {
+          return;
+        }
+      }
+    }
   }  // namespace detail
 
-  template <IterMode mode, typename T>
-  void iterate(FlowPtr<T> root, const IterCallback &cb) {  // NOLINT(readability-identifier-naming)
+  template <IterMode mode, typename T, typename Fn>
+  void iterate(FlowPtr<T> root, Fn &&cb) {  // NOLINT(readability-identifier-naming)
+    const FlowPtr<Expr> base = root;
+
     if constexpr (mode == dfs_pre) {
-      return detail::DfsPreImpl(root, cb);
+      return detail::DfsPre<true>(base, cb);
     } else if constexpr (mode == dfs_post) {
-      return detail::DfsPostImpl(root, cb);
+      return detail::DfsPost(base, cb);
     } else if constexpr (mode == bfs_pre) {
-      return detail::BfsPreImpl(root, cb);
+      return detail::Bfs<false>(base, cb);
     } else if constexpr (mode == bfs_post) {
-      return detail::BfsPostImpl(root, cb);
+      return detail::Bfs<true>(base, cb);
     } else if constexpr (mode == children) {
-      return detail::IterChildren(root, cb);
+      return detail::IterChildren(base, cb);
     } else {
       static_assert(mode != mode, "Invalid iteration mode.");
     }
   }
 
-  template <auto mode = dfs_pre>
-  void for_each(FlowPtr<Expr> v,  // NOLINT(readability-identifier-naming)
-                const std::function<void(FlowPtr<Expr>)> &f) {
-    iterate<mode>(v, [&](auto, FlowPtr<Expr> c) -> IterOp {
-      f(std::move(c));
-
-      return IterOp::Proceed;
-    });
+  /** Calls `f(node)` for every node. `f` may return an IterOp to prune or stop. */
+  template <auto mode = dfs_pre, typename Fn>
+  void for_each(FlowPtr<Expr> v, Fn &&f) {  // NOLINT(readability-identifier-naming)
+    if constexpr (mode == dfs_pre) {
+      detail::DfsPre<false>(v, f);
+    } else {
+      iterate<mode>(v, [&](const auto &, const FlowPtr<Expr> &c) -> IterOp { return detail::Invoke(f, c); });
+    }
   }
 
-  template <typename T, auto mode = dfs_pre>
-  void for_each(FlowPtr<Expr> v,  // NOLINT(readability-identifier-naming)
-                std::function<void(FlowPtr<T>)> f) {
-    iterate<mode>(v, [&](auto, FlowPtr<Expr> c) -> IterOp {
+  /** Calls `f(node)` for every node of type T. Other nodes are only walked through. */
+  template <typename T, auto mode = dfs_pre, typename Fn>
+  void for_each(FlowPtr<Expr> v, Fn &&f) {  // NOLINT(readability-identifier-naming)
+    for_each<mode>(v, [&](const FlowPtr<Expr> &c) -> IterOp {
       if (c->GetKind() != Expr::GetTypeCode<T>()) {
         return IterOp::Proceed;
       }
 
-      f(c.As<T>());
-
-      return IterOp::Proceed;
+      return detail::Invoke(f, c.template As<T>());
     });
   }
 }  // namespace ncc::parse
@@ -38,6 +38,7 @@
 #include <boost/iostreams/stream.hpp>
 #include <memory>
 #include <memory_resource>
+#include <nitrate-core/AllocateFwd.hh>
 #include <nitrate-core/EnvironmentFwd.hh>
 #include <nitrate-core/FlowPtr.hh>
 #include <nitrate-lexer/ScannerFwd.hh>
@@ -72,10 +73,41 @@ namespace ncc::parse {
     [[nodiscard]] auto Parse() -> ASTRoot;
     [[nodiscard]] auto GetLexer() -> lex::IScanner &;
 
+    /**
+     * When enabled, `Parse()` skips function bodies written as `{ ... }` and
+     * variable initializers, keeping their tokens instead. Such nodes come
+     * out without a body or initializer, and the skipped code is not checked
+     * for syntax errors until it is materialized.
+     *
+     * The scanner must outlive any later call to `Materialize()`.
+     */
+    auto SetLazyBodies(bool lazy) -> void;
+
+    [[nodiscard]] auto IsDeferred(const FlowPtr<Expr> &node) const -> bool;
+
+    /**
+     * Parses the skipped body of a `Function` or initializer of a `Variable`
+     * and attaches it to the node. Returns false if nothing was deferred for
+     * the node or if the deferred code has syntax errors.
+     */
+    auto Materialize(const FlowPtr<Expr> &node) -> bool;
+
     static auto Create(lex::IScanner &lexer, std::shared_ptr<IEnvironment> env, std::pmr::memory_resource &pool) {
       return std::make_unique<GeneralParser>(lexer, std::move(env), pool);
     }
 
+    /**
+     * Reads the whole token stream and splits it at top-level declaration
+     * boundaries. The pieces are then parsed on up to `jobs` worker threads
+     * (0 = one per core) and joined into a single block. Diagnostics are
+     * reported in source order once all workers finish.
+     *
+     * Every worker allocates from `pool`. Use ArenaSync::PerThread so that
+     * the workers do not contend on it.
+     */
+    static auto ParseParallel(lex::IScanner &lexer, std::shared_ptr<IEnvironment> env, DynamicArena &pool,
+                              size_t jobs = 0) -> ASTRoot;
+
     template <typename Scanner>
     static auto ParseString(std::string_view source, std::shared_ptr<IEnvironment> env,
                             std::pmr::memory_resource &pool) {
@@ -0,0 +1,409 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <nitrate-parser/AST.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTData.hh>
+#include <nitrate-parser/ASTExpr.hh>
+#include <nitrate-parser/ASTStmt.hh>
+#include <nitrate-parser/ASTType.hh>
+#include <nitrate-parser/ASTVisitor.hh>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+using namespace ncc;
+using namespace ncc::parse;
+
+/**
+ * Structural hashing and equality. Two nodes are equal if they are of the
+ * same kind and all of their fields are equal, recursively. Source locations,
+ * comments and the mock flag are not part of the structure.
+ */
+
+static auto HashNode(const Expr *n) -> uint64_t;
+static auto EqualNodes(const Expr *a, const Expr *b) -> bool;
+
+namespace {
+  constexpr void MixWord(uint64_t &h, uint64_t v) { h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2); }
+
+  template <typename T>
+  concept Scalar = std::is_integral_v<T> || std::is_enum_v<T>;
+
+  template <Scalar T>
+  void Mix(uint64_t &h, T v);
+  void Mix(uint64_t &h, const string &v);
+  template <typename T, typename Tr>
+  void Mix(uint64_t &h, const FlowPtr<T, Tr> &v);
+  template <typename T, typename Tr>
+  void Mix(uint64_t &h, const NullableFlowPtr<T, Tr> &v);
+  template <typename T>
+  void Mix(uint64_t &h, const std::optional<T> &v);
+  template <typename T>
+  void Mix(uint64_t &h, std::span<T> v);
+  template <typename A, typename B>
+  void Mix(uint64_t &h, const std::pair<A, B> &v);
+  template <typename... Ts>
+  void Mix(uint64_t &h, const std::tuple<Ts...> &v);
+  template <typename... Ts>
+  void Mix(uint64_t &h, const std::variant<Ts...> &v);
+  void Mix(uint64_t &h, const StructField &v);
+  void Mix(uint64_t &h, const StructFunction &v);
+
+  template <Scalar T>
+  auto Equal(T a, T b) -> bool;
+  auto Equal(const string &a, const string &b) -> bool;
+  template <typename T, typename Tr>
+  auto Equal(const FlowPtr<T, Tr> &a, const FlowPtr<T, Tr> &b) -> bool;
+  template <typename T, typename Tr>
+  auto Equal(const NullableFlowPtr<T, Tr> &a, const NullableFlowPtr<T, Tr> &b) -> bool;
+  template <typename T>
+  auto Equal(const std::optional<T> &a, const std::optional<T> &b) -> bool;
+  template <typename T>
+  auto Equal(std::span<T> a, std::span<T> b) -> bool;
+  template <typename A, typename B>
+  auto Equal(const std::pair<A, B> &a, const std::pair<A, B> &b) -> bool;
+  template <typename... Ts>
+  auto Equal(const std::tuple<Ts...> &a, const std::tuple<Ts...> &b) -> bool;
+  template <typename... Ts>
+  auto Equal(const std::variant<Ts...> &a, const std::variant<Ts...> &b) -> bool;
+  auto Equal(const StructField &a, const StructField &b) -> bool;
+  auto Equal(const StructFunction &a, const StructFunction &b) -> bool;
+
+  template <Scalar T>
+  void Mix(uint64_t &h, T v) {
+    MixWord(h, static_cast<uint64_t>(v));
+  }
+
+  void Mix(uint64_t &h, const string &v) { MixWord(h, v.Hash()); }
+
+  template <typename T, typename Tr>
+  void Mix(uint64_t &h, const FlowPtr<T, Tr> &v) {
+    MixWord(h, HashNode(v.get()));
+  }
+
+  template <typename T, typename Tr>
+  void Mix(uint64_t &h, const NullableFlowPtr<T, Tr> &v) {
+    MixWord(h, v.has_value() ? HashNode(v.value().get()) : 0);
+  }
+
+  template <typename T>
+  void Mix(uint64_t &h, const std::optional<T> &v) {
+    MixWord(h, static_cast<uint64_t>(v.has_value()));
+    if (v.has_value()) {
+      Mix(h, v.value());
+    }
+  }
+
+  template <typename T>
+  void Mix(uint64_t &h, std::span<T> v) {
+    MixWord(h, v.size());
+    for (const auto &item : v) {
+      Mix(h, item);
+    }
+  }
+
+  template <typename A, typename B>
+  void Mix(uint64_t &h, const std::pair<A, B> &v) {
+    Mix(h, v.first);
+    Mix(h, v.second);
+  }
+
+  template <typename... Ts>
+  void Mix(uint64_t &h, const std::tuple<Ts...> &v) {
+    std::apply([&](const auto &...items) { (Mix(h, items), ...); }, v);
+  }
+
+  template <typename... Ts>
+  void Mix(uint64_t &h, const std::variant<Ts...> &v) {
+    MixWord(h, v.index());
+    std::visit([&](const auto &item) { Mix(h, item); }, v);
+  }
+
+  void Mix(uint64_t &h, const StructField &v) {
+    Mix(h, v.GetVis());
+    Mix(h, v.IsStatic());
+    Mix(h, v.GetName());
+    Mix(h, v.GetType());
+    Mix(h, v.GetValue());
+  }
+
+  void Mix(uint64_t &h, const StructFunction &v) {
+    Mix(h, v.m_vis);
+    Mix(h, v.m_func);
+  }
+
+  template <Scalar T>
+  auto Equal(T a, T b) -> bool {
+    return a == b;
+  }
+
+  auto Equal(const string &a, const string &b) -> bool { return a == b; }
+
+  template <typename T, typename Tr>
+  auto Equal(const FlowPtr<T, Tr> &a, const FlowPtr<T, Tr> &b) -> bool {
+    return EqualNodes(a.get(), b.get());
+  }
+
+  template <typename T, typename Tr>
+  auto Equal(const NullableFlowPtr<T, Tr> &a, const NullableFlowPtr<T, Tr> &b) -> bool {
+    if (a.has_value() != b.has_value()) {
+      return false;
+    }
+
+    return !a.has_value() || EqualNodes(a.value().get(), b.value().get());
+  }
+
+  template <typename T>
+  auto Equal(const std::optional<T> &a, const std::optional<T> &b) -> bool {
+    if (a.has_value() != b.has_value()) {
+      return false;
+    }
+
+    return !a.has_value() || Equal(a.value(), b.value());
+  }
+
+  template <typename T>
+  auto Equal(std::span<T> a, std::span<T> b) -> bool {
+    if (a.size() != b.size()) {
+      return false;
+    }
+
+    for (size_t i = 0; i < a.size(); ++i) {
+      if (!Equal(a[i], b[i])) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  template <typename A, typename B>
+  auto Equal(const std::pair<A, B> &a, const std::pair<A, B> &b) -> bool {
+    return Equal(a.first, b.first) && Equal(a.second, b.second);
+  }
+
+  template <typename... Ts>
+  auto Equal(const std::tuple<Ts...> &a, const std::tuple<Ts...> &b) -> bool {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      return (Equal(std::get<I>(a), std::get<I>(b)) && ...);
+    }(std::index_sequence_for<Ts...>{});
+  }
+
+  template <typename... Ts>
+  auto Equal(const std::variant<Ts...> &a, const std::variant<Ts...> &b) -> bool {
+    if (a.index() != b.index()) {
+      return false;
+    }
+
+    return std::visit(
+        [&](const auto &item) {
+          using Item = std::decay_t<decltype(item)>;
+          return Equal(item, std::get<Item>(b));
+        },
+        a);
+  }
+
+  auto Equal(const StructField &a, const StructField &b) -> bool {
+    return a.GetVis() == b.GetVis() && a.IsStatic() == b.IsStatic() && a.GetName() == b.GetName() &&
+           Equal(a.GetType(), b.GetType()) && Equal(a.GetValue(), b.GetValue());
+  }
+
+  auto Equal(const StructFunction &a, const StructFunction &b) -> bool {
+    return a.m_vis == b.m_vis && Equal(a.m_func, b.m_func);
+  }
+
+  /**
+   * Lists the fields of every node kind once, as getters. In hashing mode the
+   * fields are mixed into the hash; in comparison mode they are compared
+   * against the same fields of the other node, stopping at the first
+   * difference.
+   */
+  class StructuralVisitor final : public ASTVisitor {
+    const Expr *m_other;
+    uint64_t m_hash;
+    bool m_equal = true;
+
+    template <typename T, typename... Getters>
+    void Apply(const FlowPtr<T> &n, Getters... getters) {
+      const T &a = *n.get();
+
+      if (m_other == nullptr) {
+        (Mix(m_hash, (a.*getters)()), ...);
+      } else {
+        const T &b = *m_other->As<T>();
+        m_equal = (Equal((a.*getters)(), (b.*getters)()) && ...);
+      }
+    }
+
+    template <typename T, typename... Getters>
+    void ApplyType(const FlowPtr<T> &n, Getters... getters) {
+      Apply(n, getters..., &Type::GetWidth, &Type::GetRangeBegin, &Type::GetRangeEnd);
+    }
+
+    void Visit(FlowPtr<NamedTy> n) override { ApplyType(n, &NamedTy::GetName); }
+    void Visit(FlowPtr<InferTy> n) override { ApplyType(n); }
+    void Visit(FlowPtr<TemplateType> n) override { ApplyType(n, &TemplateType::GetTemplate, &TemplateType::GetArgs); }
+    void Visit(FlowPtr<U1> n) override { ApplyType(n); }
+    void Visit(FlowPtr<U8> n) override { ApplyType(n); }
+    void Visit(FlowPtr<U16> n) override { ApplyType(n); }
+    void Visit(FlowPtr<U32> n) override { ApplyType(n); }
+    void Visit(FlowPtr<U64> n) override { ApplyType(n); }
+    void Visit(FlowPtr<U128> n) override { ApplyType(n); }
+    void Visit(FlowPtr<I8> n) override { ApplyType(n); }
+    void Visit(FlowPtr<I16> n) override { ApplyType(n); }
+    void Visit(FlowPtr<I32> n) override { ApplyType(n); }
+    void Visit(FlowPtr<I64> n) override { ApplyType(n); }
+    void Visit(FlowPtr<I128> n) override { ApplyType(n); }
+    void Visit(FlowPtr<F16> n) override { ApplyType(n); }
+    void Visit(FlowPtr<F32> n) override { ApplyType(n); }
+    void Visit(FlowPtr<F64> n) override { ApplyType(n); }
+    void Visit(FlowPtr<F128> n) override { ApplyType(n); }
+    void Visit(FlowPtr<VoidTy> n) override { ApplyType(n); }
+    void Visit(FlowPtr<PtrTy> n) override { ApplyType(n, &PtrTy::GetItem, &PtrTy::IsVolatile); }
+    void Visit(FlowPtr<OpaqueTy> n) override { ApplyType(n, &OpaqueTy::GetName); }
+    void Visit(FlowPtr<TupleTy> n) override { ApplyType(n, &TupleTy::GetItems); }
+    void Visit(FlowPtr<ArrayTy> n) override { ApplyType(n, &ArrayTy::GetItem, &ArrayTy::GetSize); }
+    void Visit(FlowPtr<RefTy> n) override { ApplyType(n, &RefTy::GetItem, &RefTy::IsVolatile); }
+
+    void Visit(FlowPtr<FuncTy> n) override {
+      ApplyType(n, &FuncTy::GetReturn, &FuncTy::GetPurity, &FuncTy::GetParams, &FuncTy::IsVariadic,
+                &FuncTy::GetAttributes);
+    }
+
+    void Visit(FlowPtr<Unary> n) override { Apply(n, &Unary::GetOp, &Unary::GetRHS); }
+    void Visit(FlowPtr<Binary> n) override { Apply(n, &Binary::GetOp, &Binary::GetLHS, &Binary::GetRHS); }
+    void Visit(FlowPtr<PostUnary> n) override { Apply(n, &PostUnary::GetOp, &PostUnary::GetLHS); }
+    void Visit(FlowPtr<Ternary> n) override { Apply(n, &Ternary::GetCond, &Ternary::GetLHS, &Ternary::GetRHS); }
+    void Visit(FlowPtr<Integer> n) override { Apply(n, &Integer::GetValue); }
+    void Visit(FlowPtr<Float> n) override { Apply(n, &Float::GetValue); }
+    void Visit(FlowPtr<Boolean> n) override { Apply(n, &Boolean::GetValue); }
+    void Visit(FlowPtr<parse::String> n) override { Apply(n, &parse::String::GetValue); }
+    void Visit(FlowPtr<Character> n) override { Apply(n, &Character::GetValue); }
+    void Visit(FlowPtr<Null> n) override { Apply(n); }
+    void Visit(FlowPtr<Undefined> n) override { Apply(n); }
+    void Visit(FlowPtr<Call> n) override { Apply(n, &Call::GetFunc, &Call::GetArgs); }
+
+    void Visit(FlowPtr<TemplateCall> n) override {
+      Apply(n, &TemplateCall::GetFunc, &TemplateCall::GetTemplateArgs, &TemplateCall::GetArgs);
+    }
+
+    void Visit(FlowPtr<List> n) override { Apply(n, &List::GetItems); }
+    void Visit(FlowPtr<Assoc> n) override { Apply(n, &Assoc::GetKey, &Assoc::GetValue); }
+    void Visit(FlowPtr<Index> n) override { Apply(n, &Index::GetBase, &Index::GetIndex); }
+    void Visit(FlowPtr<Slice> n) override { Apply(n, &Slice::GetBase, &Slice::GetStart, &Slice::GetEnd); }
+    void Visit(FlowPtr<FString> n) override { Apply(n, &FString::GetItems); }
+    void Visit(FlowPtr<Identifier> n) override { Apply(n, &Identifier::GetName); }
+    void Visit(FlowPtr<Sequence> n) override { Apply(n, &Sequence::GetItems); }
+    void Visit(FlowPtr<Block> n) override { Apply(n, &Block::GetSafety, &Block::GetStatements); }
+
+    void Visit(FlowPtr<Variable> n) override {
+      Apply(n, &Variable::GetVariableKind, &Variable::GetName, &Variable::GetType, &Variable::GetInitializer,
+            &Variable::GetAttributes);
+    }
+
+    void Visit(FlowPtr<Assembly> n) override { Apply(n, &Assembly::GetCode, &Assembly::GetArguments); }
+    void Visit(FlowPtr<If> n) override { Apply(n, &If::GetCond, &If::GetThen, &If::GetElse); }
+    void Visit(FlowPtr<While> n) override { Apply(n, &While::GetCond, &While::GetBody); }
+    void Visit(FlowPtr<For> n) override { Apply(n, &For::GetInit, &For::GetCond, &For::GetStep, &For::GetBody); }
+
+    void Visit(FlowPtr<Foreach> n) override {
+      Apply(n, &Foreach::GetIndex, &Foreach::GetValue, &Foreach::GetExpr, &Foreach::GetBody);
+    }
+
+    void Visit(FlowPtr<Break> n) override { Apply(n); }
+    void Visit(FlowPtr<Continue> n) override { Apply(n); }
+    void Visit(FlowPtr<Return> n) override { Apply(n, &Return::GetValue); }
+    void Visit(FlowPtr<ReturnIf> n) override { Apply(n, &ReturnIf::GetCond, &ReturnIf::GetValue); }
+    void Visit(FlowPtr<Case> n) override { Apply(n, &Case::GetCond, &Case::GetBody); }
+    void Visit(FlowPtr<Switch> n) override { Apply(n, &Switch::GetCond, &Switch::GetCases, &Switch::GetDefault); }
+    void Visit(FlowPtr<Typedef> n) override { Apply(n, &Typedef::GetName, &Typedef::GetType); }
+
+    void Visit(FlowPtr<Function> n) override {
+      Apply(n, &Function::GetName, &Function::GetPurity, &Function::IsVariadic, &Function::GetAttributes,
+            &Function::GetCaptures, &Function::GetTemplateParams, &Function::GetParams, &Function::GetReturn,
+            &Function::GetPrecond, &Function::GetPostcond, &Function::GetBody);
+    }
+
+    void Visit(FlowPtr<Struct> n) override {
+      Apply(n, &Struct::GetCompositeType, &Struct::GetName, &Struct::GetAttributes, &Struct::GetTemplateParams,
+            &Struct::GetNames, &Struct::GetFields, &Struct::GetMethods, &Struct::GetStaticMethods);
+    }
+
+    void Visit(FlowPtr<Enum> n) override { Apply(n, &Enum::GetName, &Enum::GetType, &Enum::GetFields); }
+    void Visit(FlowPtr<Scope> n) override { Apply(n, &Scope::GetName, &Scope::GetDeps, &Scope::GetBody); }
+
+    void Visit(FlowPtr<Export> n) override {
+      Apply(n, &Export::GetVis, &Export::GetAbiName, &Export::GetAttributes, &Export::GetBody);
+    }
+
+  public:
+    StructuralVisitor(const Expr *other, uint64_t seed) : m_other(other), m_hash(seed) {}
+
+    [[nodiscard]] auto GetHash() const -> uint64_t { return m_hash; }
+    [[nodiscard]] auto IsEqual() const -> bool { return m_equal; }
+  };
+}  // namespace
+
+static auto HashNode(const Expr *n) -> uint64_t {
+  if (n == nullptr) [[unlikely]] {
+    return 0;
+  }
+
+  StructuralVisitor v(nullptr, n->GetKind());
+  const_cast<Expr *>(n)->Accept(v);
+
+  return v.GetHash();
+}
+
+static auto EqualNodes(const Expr *a, const Expr *b) -> bool {
+  if (a == b) {
+    return true;
+  }
+
+  if (a == nullptr || b == nullptr || a->GetKind() != b->GetKind()) {
+    return false;
+  }
+
+  StructuralVisitor v(b, 0);
+  const_cast<Expr *>(a)->Accept(v);
+
+  return v.IsEqual();
+}
+
+auto Expr::IsEq(FlowPtr<Expr> o) const -> bool { return EqualNodes(this, o.get()); }
+
+auto Expr::Hash64() const -> uint64_t { return HashNode(this); }
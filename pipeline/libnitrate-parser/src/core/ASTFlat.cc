@@ -0,0 +1,1477 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <bit>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/container/small_vector.hpp>
+#include <limits>
+#include <memory>
+#include <nitrate-core/Logger.hh>
+#include <nitrate-parser/AST.hh>
+#include <nitrate-parser/ASTExpr.hh>
+#include <nitrate-parser/ASTFactory.hh>
+#include <nitrate-parser/ASTFlat.hh>
+#include <nitrate-parser/ASTStmt.hh>
+#include <nitrate-parser/ASTType.hh>
+#include <unordered_map>
+#include <vector>
+
+using namespace ncc;
+using namespace ncc::parse;
+using namespace ncc::parse::flat;
+
+namespace {
+  using Slots = boost::container::small_vector<uint32_t, 8>;
+
+  constexpr auto Tag(Slot tag, uint32_t payload) -> uint32_t { return payload << 2 | static_cast<uint32_t>(tag); }
+
+  class FlatEncoder final {
+    std::vector<uint32_t> m_words;
+    std::vector<std::string_view> m_strings;
+    std::unordered_map<std::string_view, uint32_t> m_string_ids;
+
+    auto Intern(const string &s) -> uint32_t {
+      std::string_view view = s.Get();
+      auto [it, inserted] = m_string_ids.try_emplace(view, m_strings.size());
+      if (inserted) {
+        m_strings.push_back(view);
+      }
+
+      return it->second;
+    }
+
+    void Str(Slots &slots, const string &s) { slots.push_back(Tag(Slot::String, Intern(s))); }
+    static void Value(Slots &slots, uint32_t value) { slots.push_back(Tag(Slot::Value, value)); }
+
+    /* Node slots hold the absolute word index until Emit() makes them relative */
+    template <typename T>
+    void Node(Slots &slots, const FlowPtr<T> &node) {
+      slots.push_back(Tag(Slot::Node, Encode(node.get())));
+    }
+
+    template <typename T>
+    void Node(Slots &slots, const NullableFlowPtr<T> &node) {
+      if (node.has_value()) {
+        Node(slots, node.value());
+      } else {
+        slots.push_back(Tag(Slot::Null, 0));
+      }
+    }
+
+    void Nodes(Slots &slots, const auto &items) {
+      Value(slots, items.size());
+      for (const auto &item : items) {
+        Node(slots, item);
+      }
+    }
+
+    void Args(Slots &slots, std::span<const CallArg> args) {
+      Value(slots, args.size());
+      for (const auto &[name, value] : args) {
+        Str(slots, name);
+        Node(slots, value);
+      }
+    }
+
+    void Params(Slots &slots, std::span<const FuncParam> params) {
+      Value(slots, params.size());
+      for (const auto &[name, type, default_value] : params) {
+        Str(slots, name);
+        Node(slots, type);
+        Node(slots, default_value);
+      }
+    }
+
+    void TemplateParams(Slots &slots, const std::optional<std::span<TemplateParameter>> &params) {
+      Value(slots, params.has_value() ? 1 : 0);
+      if (params.has_value()) {
+        Params(slots, params.value());
+      }
+    }
+
+    auto Emit(const Expr *n, uint16_t scalar, const Slots &slots) -> uint32_t {
+      auto pos = static_cast<uint32_t>(m_words.size());
+      auto comments = n->Comments();
+      uint32_t flags = n->IsMock() ? kMock : 0;
+
+      m_words.push_back(static_cast<uint32_t>(n->GetKind()) | flags << 8 | static_cast<uint32_t>(scalar) << 16);
+      m_words.push_back(slots.size());
+      m_words.push_back(comments.size());
+
+      for (auto slot : slots) {
+        if (static_cast<Slot>(slot & 3) == Slot::Node) {
+          slot = Tag(Slot::Node, pos - (slot >> 2));
+        }
+        m_words.push_back(slot);
+      }
+
+      for (const auto &comment : comments) {
+        m_words.push_back(Intern(comment));
+      }
+
+      return pos;
+    }
+
+  public:
+    auto Encode(const Expr *n) -> uint32_t;
+    void Finish(std::ostream &os, uint32_t root) const;
+  };
+
+  auto FlatEncoder::Encode(const Expr *n) -> uint32_t {
+    Slots slots;
+    uint16_t scalar = 0;
+
+    if (n->IsType()) {
+      const auto *type = n->As<Type>();
+      Node(slots, type->GetWidth());
+      Node(slots, type->GetRangeBegin());
+      Node(slots, type->GetRangeEnd());
+    }
+
+    switch (n->GetKind()) {
+      case QAST_BINEXPR: {
+        const auto *x = n->As<Binary>();
+        scalar = x->GetOp();
+        Node(slots, x->GetLHS());
+        Node(slots, x->GetRHS());
+        break;
+      }
+
+      case QAST_UNEXPR: {
+        const auto *x = n->As<Unary>();
+        scalar = x->GetOp();
+        Node(slots, x->GetRHS());
+        break;
+      }
+
+      case QAST_POST_UNEXPR: {
+        const auto *x = n->As<PostUnary>();
+        scalar = x->GetOp();
+        Node(slots, x->GetLHS());
+        break;
+      }
+
+      case QAST_TEREXPR: {
+        const auto *x = n->As<Ternary>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetLHS());
+        Node(slots, x->GetRHS());
+        break;
+      }
+
+      case QAST_INT: {
+        Str(slots, n->As<Integer>()->GetValue());
+        break;
+      }
+
+      case QAST_FLOAT: {
+        Str(slots, n->As<Float>()->GetValue());
+        break;
+      }
+
+      case QAST_STRING: {
+        Str(slots, n->As<parse::String>()->GetValue());
+        break;
+      }
+
+      case QAST_CHAR: {
+        scalar = n->As<Character>()->GetValue();
+        break;
+      }
+
+      case QAST_BOOL: {
+        scalar = n->As<Boolean>()->GetValue() ? 1 : 0;
+        break;
+      }
+
+      case QAST_NULL:
+      case QAST_UNDEF:
+      case QAST_BREAK:
+      case QAST_CONTINUE: {
+        break;
+      }
+
+      case QAST_CALL: {
+        const auto *x = n->As<Call>();
+        Node(slots, x->GetFunc());
+        Args(slots, x->GetArgs());
+        break;
+      }
+
+      case QAST_TEMPL_CALL: {
+        const auto *x = n->As<TemplateCall>();
+        Node(slots, x->GetFunc());
+        Args(slots, x->GetTemplateArgs());
+        Args(slots, x->GetArgs());
+        break;
+      }
+
+      case QAST_LIST: {
+        Nodes(slots, n->As<List>()->GetItems());
+        break;
+      }
+
+      case QAST_ASSOC: {
+        const auto *x = n->As<Assoc>();
+        Node(slots, x->GetKey());
+        Node(slots, x->GetValue());
+        break;
+      }
+
+      case QAST_INDEX: {
+        const auto *x = n->As<Index>();
+        Node(slots, x->GetBase());
+        Node(slots, x->GetIndex());
+        break;
+      }
+
+      case QAST_SLICE: {
+        const auto *x = n->As<Slice>();
+        Node(slots, x->GetBase());
+        Node(slots, x->GetStart());
+        Node(slots, x->GetEnd());
+        break;
+      }
+
+      case QAST_FSTRING: {
+        const auto items = n->As<FString>()->GetItems();
+        Value(slots, items.size());
+        for (const auto &item : items) {
+          if (std::holds_alternative<string>(item)) {
+            Str(slots, std::get<string>(item));
+          } else {
+            Node(slots, std::get<FlowPtr<Expr>>(item));
+          }
+        }
+        break;
+      }
+
+      case QAST_IDENT: {
+        Str(slots, n->As<Identifier>()->GetName());
+        break;
+      }
+
+      case QAST_SEQ: {
+        Nodes(slots, n->As<Sequence>()->GetItems());
+        break;
+      }
+
+      case QAST_U1:
+      case QAST_U8:
+      case QAST_U16:
+      case QAST_U32:
+      case QAST_U64:
+      case QAST_U128:
+      case QAST_I8:
+      case QAST_I16:
+      case QAST_I32:
+      case QAST_I64:
+      case QAST_I128:
+      case QAST_F16:
+      case QAST_F32:
+      case QAST_F64:
+      case QAST_F128:
+      case QAST_VOID:
+      case QAST_INFER: {
+        break;
+      }
+
+      case QAST_OPAQUE: {
+        Str(slots, n->As<OpaqueTy>()->GetName());
+        break;
+      }
+
+      case QAST_NAMED: {
+        Str(slots, n->As<NamedTy>()->GetName());
+        break;
+      }
+
+      case QAST_REF: {
+        const auto *x = n->As<RefTy>();
+        scalar = x->IsVolatile() ? 1 : 0;
+        Node(slots, x->GetItem());
+        break;
+      }
+
+      case QAST_PTR: {
+        const auto *x = n->As<PtrTy>();
+        scalar = x->IsVolatile() ? 1 : 0;
+        Node(slots, x->GetItem());
+        break;
+      }
+
+      case QAST_ARRAY: {
+        const auto *x = n->As<ArrayTy>();
+        Node(slots, x->GetItem());
+        Node(slots, x->GetSize());
+        break;
+      }
+
+      case QAST_TUPLE: {
+        Nodes(slots, n->As<TupleTy>()->GetItems());
+        break;
+      }
+
+      case QAST_TEMPLATE: {
+        const auto *x = n->As<TemplateType>();
+        Node(slots, x->GetTemplate());
+        Args(slots, x->GetArgs());
+        break;
+      }
+
+      case QAST_FUNCTOR: {
+        const auto *x = n->As<FuncTy>();
+        scalar = static_cast<uint16_t>(x->GetPurity()) | (x->IsVariadic() ? 1U << 8 : 0U);
+        Node(slots, x->GetReturn());
+        Params(slots, x->GetParams());
+        Nodes(slots, x->GetAttributes());
+        break;
+      }
+
+      case QAST_IF: {
+        const auto *x = n->As<If>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetThen());
+        Node(slots, x->GetElse());
+        break;
+      }
+
+      case QAST_RETIF: {
+        const auto *x = n->As<ReturnIf>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetValue());
+        break;
+      }
+
+      case QAST_SWITCH: {
+        const auto *x = n->As<Switch>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetDefault());
+        Nodes(slots, x->GetCases());
+        break;
+      }
+
+      case QAST_CASE: {
+        const auto *x = n->As<Case>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetBody());
+        break;
+      }
+
+      case QAST_RETURN: {
+        Node(slots, n->As<Return>()->GetValue());
+        break;
+      }
+
+      case QAST_WHILE: {
+        const auto *x = n->As<While>();
+        Node(slots, x->GetCond());
+        Node(slots, x->GetBody());
+        break;
+      }
+
+      case QAST_FOR: {
+        const auto *x = n->As<For>();
+        Node(slots, x->GetInit());
+        Node(slots, x->GetCond());
+        Node(slots, x->GetStep());
+        Node(slots, x->GetBody());
+        break;
+      }
+
+      case QAST_FOREACH: {
+        const auto *x = n->As<Foreach>();
+        Str(slots, x->GetIndex());
+        Str(slots, x->GetValue());
+        Node(slots, x->GetExpr());
+        Node(slots, x->GetBody());
+        break;
+      }
+
+      case QAST_INLINE_ASM: {
+        const auto *x = n->As<Assembly>();
+        Str(slots, x->GetCode());
+        Nodes(slots, x->GetArguments());
+        break;
+      }
+
+      case QAST_TYPEDEF: {
+        const auto *x = n->As<Typedef>();
+        Str(slots, x->GetName());
+        Node(slots, x->GetType());
+        break;
+      }
+
+      case QAST_STRUCT: {
+        const auto *x = n->As<Struct>();
+        scalar = static_cast<uint16_t>(x->GetCompositeType());
+        Str(slots, x->GetName());
+        Nodes(slots, x->GetAttributes());
+
+        Value(slots, x->GetNames().size());
+        for (const auto &name : x->GetNames()) {
+          Str(slots, name);
+        }
+
+        Value(slots, x->GetFields().size());
+        for (const auto &field : x->GetFields()) {
+          Value(slots, static_cast<uint32_t>(field.GetVis()) | (field.IsStatic() ? 1U << 8 : 0U));
+          Str(slots, field.GetName());
+          Node(slots, field.GetType());
+          Node(slots, field.GetValue());
+        }
+
+        for (const auto &methods : {x->GetMethods(), x->GetStaticMethods()}) {
+          Value(slots, methods.size());
+          for (const auto &method : methods) {
+            Value(slots, static_cast<uint32_t>(method.m_vis));
+            Node(slots, method.m_func);
+          }
+        }
+
+        TemplateParams(slots, x->GetTemplateParams());
+        break;
+      }
+
+      case QAST_ENUM: {
+        const auto *x = n->As<Enum>();
+        Str(slots, x->GetName());
+        Node(slots, x->GetType());
+        Value(slots, x->GetFields().size());
+        for (const auto &[name, value] : x->GetFields()) {
+          Str(slots, name);
+          Node(slots, value);
+        }
+        break;
+      }
+
+      case QAST_SCOPE: {
+        const auto *x = n->As<Scope>();
+        Str(slots, x->GetName());
+        Node(slots, x->GetBody());
+        Value(slots, x->GetDeps().size());
+        for (const auto &dep : x->GetDeps()) {
+          Str(slots, dep);
+        }
+        break;
+      }
+
+      case QAST_BLOCK: {
+        const auto *x = n->As<Block>();
+        scalar = static_cast<uint16_t>(x->GetSafety());
+        Nodes(slots, x->GetStatements());
+        break;
+      }
+
+      case QAST_EXPORT: {
+        const auto *x = n->As<Export>();
+        scalar = static_cast<uint16_t>(x->GetVis());
+        Str(slots, x->GetAbiName());
+        Node(slots, x->GetBody());
+        Nodes(slots, x->GetAttributes());
+        break;
+      }
+
+      case QAST_VAR: {
+        const auto *x = n->As<Variable>();
+        scalar = static_cast<uint16_t>(x->GetVariableKind());
+        Str(slots, x->GetName());
+        Node(slots, x->GetType());
+        Node(slots, x->GetInitializer());
+        Nodes(slots, x->GetAttributes());
+        break;
+      }
+
+      case QAST_FUNCTION: {
+        const auto *x = n->As<Function>();
+        scalar = static_cast<uint16_t>(x->GetPurity()) | (x->IsVariadic() ? 1U << 8 : 0U);
+        Str(slots, x->GetName());
+        Node(slots, x->GetReturn());
+        Node(slots, x->GetPrecond());
+        Node(slots, x->GetPostcond());
+        Node(slots, x->GetBody());
+        Nodes(slots, x->GetAttributes());
+
+        Value(slots, x->GetCaptures().size());
+        for (const auto &[name, is_ref] : x->GetCaptures()) {
+          Str(slots, name);
+          Value(slots, is_ref ? 1 : 0);
+        }
+
+        Params(slots, x->GetParams());
+        TemplateParams(slots, x->GetTemplateParams());
+        break;
+      }
+    }
+
+    return Emit(n, scalar, slots);
+  }
+
+  void FlatEncoder::Finish(std::ostream &os, uint32_t root) const {
+    std::vector<uint32_t> offsets;
+    offsets.reserve(m_strings.size() + 1);
+    offsets.push_back(0);
+
+    size_t bytes = 0;
+    for (const auto &s : m_strings) {
+      bytes += s.size();
+      offsets.push_back(bytes);
+    }
+
+    constexpr auto kLimit = std::numeric_limits<uint32_t>::max();
+    const size_t nodes_size = m_words.size() * sizeof(uint32_t);
+    const size_t string_size = sizeof(uint32_t) * (offsets.size() + 1) + bytes;
+    if (nodes_size > kLimit || string_size > kLimit || sizeof(Header) + nodes_size + string_size > kLimit)
+        [[unlikely]] {
+      qcore_panic("Syntax tree is too large for the flat AST format");
+    }
+
+    Header header = {kMagic, kVersion, static_cast<uint32_t>(nodes_size), root * 4,
+                     static_cast<uint32_t>(string_size), 0};
+    auto string_count = static_cast<uint32_t>(m_strings.size());
+
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char *>(m_words.data()), nodes_size);
+    os.write(reinterpret_cast<const char *>(&string_count), sizeof(string_count));
+    os.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    for (const auto &s : m_strings) {
+      os.write(s.data(), s.size());
+    }
+  }
+}  // namespace
+
+void FlatAstWriter::Write(const FlowPtr<Expr> &root) {
+  FlatEncoder encoder;
+  auto root_offset = encoder.Encode(root.get());
+  encoder.Finish(m_os, root_offset);
+}
+
+auto FlatAst::Open(std::string_view data) -> std::optional<FlatAst> {
+  if constexpr (std::endian::native != std::endian::little) {
+    return std::nullopt;
+  }
+
+  Header header;
+  if (data.size() < sizeof(header)) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.m_magic != kMagic || header.m_version != kVersion) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  if (header.m_nodes_size == 0 || header.m_nodes_size % 4 != 0 || header.m_root % 4 != 0 ||
+      header.m_root >= header.m_nodes_size ||
+      sizeof(header) + uint64_t(header.m_nodes_size) + header.m_string_size != data.size()) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  FlatAst ast;
+  ast.m_nodes = data.data() + sizeof(header);
+  ast.m_strings = ast.m_nodes + header.m_nodes_size;
+  ast.m_nodes_size = header.m_nodes_size;
+  ast.m_root = header.m_root;
+
+  { /* String table: count, count + 1 offsets, bytes */
+    if (header.m_string_size < 8) [[unlikely]] {
+      return std::nullopt;
+    }
+
+    const uint64_t count = LoadWord(ast.m_strings);
+    const uint64_t table_size = 8 + count * 4;
+    if (table_size > header.m_string_size) [[unlikely]] {
+      return std::nullopt;
+    }
+
+    const uint64_t bytes = header.m_string_size - table_size;
+    uint32_t previous = 0;
+    for (uint64_t i = 0; i <= count; ++i) {
+      auto offset = LoadWord(ast.m_strings + 4 + i * 4);
+      if (offset < previous || offset > bytes || (i == 0 && offset != 0)) [[unlikely]] {
+        return std::nullopt;
+      }
+      previous = offset;
+    }
+  }
+
+  { /* Node records: every reference must point back to the start of a record */
+    const uint32_t words = header.m_nodes_size / 4;
+    const uint32_t string_count = ast.StringCount();
+    std::vector<bool> starts(words, false);
+
+    for (uint32_t w = 0; w < words;) {
+      if (words - w < 3) [[unlikely]] {
+        return std::nullopt;
+      }
+
+      auto node = ast.At(w * 4);
+      auto head = LoadWord(ast.m_nodes + w * 4);
+      if ((head & 0xff) > QAST__LAST || ((head >> 8) & 0xff & ~kMock) != 0) [[unlikely]] {
+        return std::nullopt;
+      }
+
+      const uint64_t size = 3 + uint64_t(node.SlotCount()) + node.CommentCount();
+      if (size > words - w) [[unlikely]] {
+        return std::nullopt;
+      }
+
+      for (uint32_t i = 0; i < node.SlotCount(); ++i) {
+        auto payload = node.GetValue(i);
+
+        switch (node.GetSlotKind(i)) {
+          case Slot::Null: {
+            if (payload != 0) [[unlikely]] {
+              return std::nullopt;
+            }
+            break;
+          }
+
+          case Slot::Node: {
+            if (payload == 0 || payload > w || !starts[w - payload]) [[unlikely]] {
+              return std::nullopt;
+            }
+            break;
+          }
+
+          case Slot::String: {
+            if (payload >= string_count) [[unlikely]] {
+              return std::nullopt;
+            }
+            break;
+          }
+
+          case Slot::Value: {
+            break;
+          }
+        }
+      }
+
+      for (uint32_t i = 0; i < node.CommentCount(); ++i) {
+        if (LoadWord(ast.m_nodes + (w + 3 + node.SlotCount() + i) * 4) >= string_count) [[unlikely]] {
+          return std::nullopt;
+        }
+      }
+
+      starts[w] = true;
+      w += size;
+    }
+
+    if (!starts[header.m_root / 4]) [[unlikely]] {
+      return std::nullopt;
+    }
+  }
+
+  return ast;
+}
+
+namespace {
+  template <typename T>
+  auto IsA(const Expr *n) -> bool {
+    if constexpr (std::is_same_v<T, Expr>) {
+      return true;
+    } else if constexpr (std::is_same_v<T, Type>) {
+      return n->IsType();
+    } else {
+      return n->Is<T>();
+    }
+  }
+
+  class FlatDecoder final {
+    const FlatAst &m_ast;
+    std::pmr::memory_resource &m_pool;
+    ASTFactory m_fac;
+    std::vector<Expr *> m_nodes; /* Decoded records by word offset */
+    std::vector<string> m_strings;
+    std::vector<bool> m_interned;
+
+    auto Intern(uint32_t id) -> string {
+      if (!m_interned[id]) {
+        m_strings[id] = string(m_ast.GetString(id));
+        m_interned[id] = true;
+      }
+
+      return m_strings[id];
+    }
+
+    /* Reads the slots of one record in order, checking each tag */
+    class Cursor final {
+      FlatDecoder &m_dec;
+      FlatNode m_node;
+      uint32_t m_i = 0;
+      bool m_ok = true;
+
+      auto Take(Slot tag) -> bool {
+        if (m_i >= m_node.SlotCount() || m_node.GetSlotKind(m_i) != tag) [[unlikely]] {
+          m_ok = false;
+          return false;
+        }
+
+        return true;
+      }
+
+    public:
+      Cursor(FlatDecoder &dec, FlatNode node) : m_dec(dec), m_node(node) {}
+
+      template <typename T = Expr>
+      auto Maybe() -> NullableFlowPtr<T> {
+        if (m_i < m_node.SlotCount() && m_node.GetSlotKind(m_i) == Slot::Null) {
+          ++m_i;
+          return nullptr;
+        }
+
+        if (!Take(Slot::Node)) [[unlikely]] {
+          return nullptr;
+        }
+
+        auto *child = m_dec.m_nodes[m_node.GetNode(m_i++).GetOffset() / 4];
+        if (!IsA<T>(child)) [[unlikely]] {
+          m_ok = false;
+          return nullptr;
+        }
+
+        return static_cast<T *>(child);
+      }
+
+      template <typename T = Expr>
+      auto Node() -> NullableFlowPtr<T> {
+        auto node = Maybe<T>();
+        m_ok = m_ok && node.has_value();
+        return node;
+      }
+
+      auto String() -> string {
+        if (!Take(Slot::String)) [[unlikely]] {
+          return "";
+        }
+
+        return m_dec.Intern(m_node.GetStringId(m_i++));
+      }
+
+      auto Value() -> uint32_t { return Take(Slot::Value) ? m_node.GetValue(m_i++) : 0; }
+
+      [[nodiscard]] auto Peek() const -> std::optional<Slot> {
+        return m_i < m_node.SlotCount() ? std::optional(m_node.GetSlotKind(m_i)) : std::nullopt;
+      }
+
+      /* A list length; it can not exceed the slots that are left */
+      auto Count() -> uint32_t {
+        auto count = Value();
+        if (count > m_node.SlotCount() - m_i) [[unlikely]] {
+          m_ok = false;
+          return 0;
+        }
+
+        return count;
+      }
+
+      void Fail() { m_ok = false; }
+
+      [[nodiscard]] auto Ok() const -> bool { return m_ok; }
+      [[nodiscard]] auto Done() const -> bool { return m_ok && m_i == m_node.SlotCount(); }
+    };
+
+    template <typename T = Expr>
+    static auto Nodes(Cursor &c) -> std::vector<FlowPtr<T>>;
+    static auto Args(Cursor &c) -> std::vector<CallArg>;
+    static auto Params(Cursor &c) -> std::vector<FuncParam>;
+    static auto TemplateParams(Cursor &c) -> std::optional<std::vector<TemplateParameter>>;
+
+    auto Decode(FlatNode node) -> Expr *;
+    auto DecodeType(FlatNode node, Cursor &c) -> Expr *;
+
+  public:
+    FlatDecoder(const FlatAst &ast, std::pmr::memory_resource &pool)
+        : m_ast(ast),
+          m_pool(pool),
+          m_fac(pool),
+          m_nodes(ast.NodesSize() / 4, nullptr),
+          m_strings(ast.StringCount()),
+          m_interned(ast.StringCount(), false) {}
+
+    auto Run() -> NullableFlowPtr<Expr>;
+  };
+}  // namespace
+
+template <typename T>
+auto FlatDecoder::Nodes(Cursor &c) -> std::vector<FlowPtr<T>> {
+  auto count = c.Count();
+
+  std::vector<FlowPtr<T>> items;
+  items.reserve(count);
+  for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+    if (auto item = c.template Node<T>()) {
+      items.push_back(item.value());
+    }
+  }
+
+  return items;
+}
+
+auto FlatDecoder::Args(Cursor &c) -> std::vector<CallArg> {
+  auto count = c.Count();
+
+  std::vector<CallArg> args;
+  args.reserve(count);
+  for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+    auto name = c.String();
+    if (auto value = c.Node()) {
+      args.emplace_back(name, value.value());
+    }
+  }
+
+  return args;
+}
+
+auto FlatDecoder::Params(Cursor &c) -> std::vector<FuncParam> {
+  auto count = c.Count();
+
+  std::vector<FuncParam> params;
+  params.reserve(count);
+  for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+    auto name = c.String();
+    auto type = c.Node<Type>();
+    auto default_value = c.Maybe();
+    if (type.has_value()) {
+      params.emplace_back(name, type.value(), default_value);
+    }
+  }
+
+  return params;
+}
+
+auto FlatDecoder::TemplateParams(Cursor &c) -> std::optional<std::vector<TemplateParameter>> {
+  switch (c.Value()) {
+    case 0:
+      return std::nullopt;
+    case 1:
+      return Params(c);
+    default:
+      c.Fail();
+      return std::nullopt;
+  }
+}
+
+static constexpr auto IsOperator(uint16_t scalar) -> bool {
+  return scalar >= lex::Op_First && scalar <= lex::Op_Last;
+}
+
+static constexpr auto IsPurityAndVariadic(uint16_t scalar) -> bool {
+  return (scalar & 0xff) <= static_cast<uint16_t>(Purity::Retro) && (scalar >> 8) <= 1;
+}
+
+auto FlatDecoder::DecodeType(FlatNode node, Cursor &c) -> Expr * {
+  const auto scalar = node.GetScalar();
+  auto width = c.Maybe();
+  auto min = c.Maybe();
+  auto max = c.Maybe();
+
+  switch (node.GetKind()) {
+#define SIMPLE_TYPE(kind, factory)                                     \
+  case kind: {                                                         \
+    return c.Done() ? m_fac.factory(width, min, max).get() : nullptr; \
+  }
+
+    SIMPLE_TYPE(QAST_U1, CreateU1)
+    SIMPLE_TYPE(QAST_U8, CreateU8)
+    SIMPLE_TYPE(QAST_U16, CreateU16)
+    SIMPLE_TYPE(QAST_U32, CreateU32)
+    SIMPLE_TYPE(QAST_U64, CreateU64)
+    SIMPLE_TYPE(QAST_U128, CreateU128)
+    SIMPLE_TYPE(QAST_I8, CreateI8)
+    SIMPLE_TYPE(QAST_I16, CreateI16)
+    SIMPLE_TYPE(QAST_I32, CreateI32)
+    SIMPLE_TYPE(QAST_I64, CreateI64)
+    SIMPLE_TYPE(QAST_I128, CreateI128)
+    SIMPLE_TYPE(QAST_F16, CreateF16)
+    SIMPLE_TYPE(QAST_F32, CreateF32)
+    SIMPLE_TYPE(QAST_F64, CreateF64)
+    SIMPLE_TYPE(QAST_F128, CreateF128)
+    SIMPLE_TYPE(QAST_VOID, CreateVoid)
+    SIMPLE_TYPE(QAST_INFER, CreateUnknownType)
+
+#undef SIMPLE_TYPE
+
+    case QAST_OPAQUE: {
+      auto name = c.String();
+      return c.Done() ? m_fac.CreateOpaque(name, width, min, max).get() : nullptr;
+    }
+
+    case QAST_NAMED: {
+      auto name = c.String();
+      return c.Done() ? m_fac.CreateNamed(name, width, min, max).get() : nullptr;
+    }
+
+    case QAST_REF: {
+      auto item = c.Node<Type>();
+      if (!c.Done() || scalar > 1) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateReference(item.value(), scalar != 0, width, min, max).get();
+    }
+
+    case QAST_PTR: {
+      auto item = c.Node<Type>();
+      if (!c.Done() || scalar > 1) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreatePointer(item.value(), scalar != 0, width, min, max).get();
+    }
+
+    case QAST_ARRAY: {
+      auto item = c.Node<Type>();
+      auto size = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateArray(item.value(), size.value(), width, min, max).get();
+    }
+
+    case QAST_TUPLE: {
+      auto items = Nodes<Type>(c);
+      return c.Done() ? m_fac.CreateTuple(items, width, min, max).get() : nullptr;
+    }
+
+    case QAST_TEMPLATE: {
+      auto templ = c.Node<Type>();
+      auto args = Args(c);
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateTemplateType(args, templ.value(), width, min, max).get();
+    }
+
+    case QAST_FUNCTOR: {
+      auto return_type = c.Node<Type>();
+      auto params = Params(c);
+      auto attributes = Nodes(c);
+      if (!c.Done() || !IsPurityAndVariadic(scalar)) [[unlikely]] {
+        return nullptr;
+      }
+
+      auto object = m_fac.CreateFunctionType(return_type.value(), std::span<const FuncParam>(params), (scalar >> 8) != 0,
+                                             static_cast<Purity>(scalar & 0xff),
+                                             std::span<const FlowPtr<Expr>>(attributes), width, min, max);
+      return object.has_value() ? object.value().get() : nullptr;
+    }
+
+    default: {
+      return nullptr;
+    }
+  }
+}
+
+auto FlatDecoder::Decode(FlatNode node) -> Expr * {
+  Cursor c(*this, node);
+  const auto scalar = node.GetScalar();
+
+  if (node.GetKind() >= QAST__TYPE_FIRST && node.GetKind() <= QAST__TYPE_LAST) {
+    return DecodeType(node, c);
+  }
+
+  switch (node.GetKind()) {
+    case QAST_BINEXPR: {
+      auto lhs = c.Node();
+      auto rhs = c.Node();
+      if (!c.Done() || !IsOperator(scalar)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateBinary(lhs.value(), static_cast<lex::Operator>(scalar), rhs.value()).get();
+    }
+
+    case QAST_UNEXPR: {
+      auto rhs = c.Node();
+      if (!c.Done() || !IsOperator(scalar)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateUnary(static_cast<lex::Operator>(scalar), rhs.value()).get();
+    }
+
+    case QAST_POST_UNEXPR: {
+      auto lhs = c.Node();
+      if (!c.Done() || !IsOperator(scalar)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreatePostUnary(lhs.value(), static_cast<lex::Operator>(scalar)).get();
+    }
+
+    case QAST_TEREXPR: {
+      auto cond = c.Node();
+      auto lhs = c.Node();
+      auto rhs = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateTernary(cond.value(), lhs.value(), rhs.value()).get();
+    }
+
+    case QAST_INT: {
+      auto value = c.String();
+      return c.Done() ? m_fac.CreateIntegerUnchecked(value).get() : nullptr;
+    }
+
+    case QAST_FLOAT: {
+      auto value = c.String();
+      return c.Done() ? m_fac.CreateFloatUnchecked(value).get() : nullptr;
+    }
+
+    case QAST_STRING: {
+      auto value = c.String();
+      return c.Done() ? m_fac.CreateString(value).get() : nullptr;
+    }
+
+    case QAST_CHAR: {
+      if (!c.Done() || scalar > 0xff) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateCharacter(static_cast<char8_t>(scalar)).get();
+    }
+
+    case QAST_BOOL: {
+      if (!c.Done() || scalar > 1) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateBoolean(scalar != 0).get();
+    }
+
+    case QAST_NULL: {
+      return c.Done() ? m_fac.CreateNull().get() : nullptr;
+    }
+
+    case QAST_UNDEF: {
+      return c.Done() ? m_fac.CreateUndefined().get() : nullptr;
+    }
+
+    case QAST_CALL: {
+      auto func = c.Node();
+      auto args = Args(c);
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateCall(args, func.value()).get();
+    }
+
+    case QAST_TEMPL_CALL: {
+      auto func = c.Node();
+      auto template_args = Args(c);
+      auto args = Args(c);
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateTemplateCall(template_args, args, func.value()).get();
+    }
+
+    case QAST_LIST: {
+      auto items = Nodes(c);
+      return c.Done() ? m_fac.CreateList(items).get() : nullptr;
+    }
+
+    case QAST_ASSOC: {
+      auto key = c.Node();
+      auto value = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateAssociation(key.value(), value.value()).get();
+    }
+
+    case QAST_INDEX: {
+      auto base = c.Node();
+      auto index = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateIndex(base.value(), index.value()).get();
+    }
+
+    case QAST_SLICE: {
+      auto base = c.Node();
+      auto start = c.Node();
+      auto end = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateSlice(base.value(), start.value(), end.value()).get();
+    }
+
+    case QAST_FSTRING: {
+      auto count = c.Count();
+
+      std::vector<std::variant<string, FlowPtr<Expr>>> parts;
+      parts.reserve(count);
+      for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+        if (c.Peek() == Slot::String) {
+          parts.emplace_back(c.String());
+        } else if (auto part = c.Node()) {
+          parts.emplace_back(part.value());
+        }
+      }
+
+      return c.Done() ? m_fac.CreateFormatString(parts).get() : nullptr;
+    }
+
+    case QAST_IDENT: {
+      auto name = c.String();
+      return c.Done() ? m_fac.CreateIdentifier(name).get() : nullptr;
+    }
+
+    case QAST_SEQ: {
+      auto items = Nodes(c);
+      return c.Done() ? m_fac.CreateSequence(items).get() : nullptr;
+    }
+
+    case QAST_IF: {
+      auto cond = c.Node();
+      auto then = c.Node();
+      auto ele = c.Maybe();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateIf(cond.value(), then.value(), ele).get();
+    }
+
+    case QAST_RETIF: {
+      auto cond = c.Node();
+      auto value = c.Maybe();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateReturnIf(cond.value(), value).get();
+    }
+
+    case QAST_SWITCH: {
+      auto cond = c.Node();
+      auto default_ = c.Maybe();
+      auto cases = Nodes<Case>(c);
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateSwitch(cond.value(), default_, cases).get();
+    }
+
+    case QAST_CASE: {
+      auto cond = c.Node();
+      auto body = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateCase(cond.value(), body.value()).get();
+    }
+
+    case QAST_RETURN: {
+      auto value = c.Maybe();
+      return c.Done() ? m_fac.CreateReturn(value).get() : nullptr;
+    }
+
+    case QAST_BREAK: {
+      return c.Done() ? m_fac.CreateBreak().get() : nullptr;
+    }
+
+    case QAST_CONTINUE: {
+      return c.Done() ? m_fac.CreateContinue().get() : nullptr;
+    }
+
+    case QAST_WHILE: {
+      auto cond = c.Node();
+      auto body = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateWhile(cond.value(), body.value()).get();
+    }
+
+    case QAST_FOR: {
+      auto init = c.Maybe();
+      auto cond = c.Maybe();
+      auto step = c.Maybe();
+      auto body = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateFor(init, cond, step, body.value()).get();
+    }
+
+    case QAST_FOREACH: {
+      auto index = c.String();
+      auto value = c.String();
+      auto expr = c.Node();
+      auto body = c.Node();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateForeach(index, value, expr.value(), body.value()).get();
+    }
+
+    case QAST_INLINE_ASM: {
+      auto code = c.String();
+      auto args = Nodes(c);
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      auto object = m_fac.CreateAssembly(code);
+      if (!args.empty()) {
+        auto *buffer = static_cast<FlowPtr<Expr> *>(
+            m_pool.allocate(sizeof(FlowPtr<Expr>) * args.size(), alignof(FlowPtr<Expr>)));
+        std::uninitialized_copy(args.begin(), args.end(), buffer);
+        object->SetArguments(std::span<FlowPtr<Expr>>(buffer, args.size()));
+      }
+
+      return object.get();
+    }
+
+    case QAST_TYPEDEF: {
+      auto name = c.String();
+      auto type = c.Node<Type>();
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateTypedef(name, type.value()).get();
+    }
+
+    case QAST_STRUCT: {
+      auto name = c.String();
+      auto attributes = Nodes(c);
+
+      std::vector<string> names(c.Count());
+      for (auto &item : names) {
+        item = c.String();
+      }
+
+      std::vector<StructField> fields;
+      auto field_count = c.Count();
+      fields.reserve(field_count);
+      for (uint32_t i = 0; i < field_count && c.Ok(); ++i) {
+        auto flags = c.Value();
+        auto field_name = c.String();
+        auto type = c.Node<Type>();
+        auto value = c.Maybe();
+        if ((flags & 0xff) > static_cast<uint32_t>(Vis::Pro) || (flags >> 8) > 1) [[unlikely]] {
+          c.Fail();
+        } else if (type.has_value()) {
+          fields.emplace_back(static_cast<Vis>(flags & 0xff), (flags >> 8) != 0, field_name, type.value(), value);
+        }
+      }
+
+      std::array<std::vector<StructFunction>, 2> methods;
+      for (auto &list : methods) {
+        auto count = c.Count();
+        list.reserve(count);
+        for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+          auto vis = c.Value();
+          auto func = c.Node();
+          if (vis > static_cast<uint32_t>(Vis::Pro)) [[unlikely]] {
+            c.Fail();
+          } else if (func.has_value()) {
+            list.emplace_back(static_cast<Vis>(vis), func.value());
+          }
+        }
+      }
+
+      auto template_params = TemplateParams(c);
+      if (!c.Done() || scalar > static_cast<uint16_t>(CompositeType::Union)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac
+          .CreateStruct(static_cast<CompositeType>(scalar), name, template_params, fields, methods[0], methods[1],
+                        names, attributes)
+          .get();
+    }
+
+    case QAST_ENUM: {
+      auto name = c.String();
+      auto type = c.Maybe<Type>();
+
+      std::vector<std::pair<string, NullableFlowPtr<Expr>>> items;
+      auto count = c.Count();
+      items.reserve(count);
+      for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+        auto item_name = c.String();
+        items.emplace_back(item_name, c.Maybe());
+      }
+
+      return c.Done() ? m_fac.CreateEnum(name, items, type).get() : nullptr;
+    }
+
+    case QAST_SCOPE: {
+      auto name = c.String();
+      auto body = c.Node();
+
+      std::vector<string> deps(c.Count());
+      for (auto &dep : deps) {
+        dep = c.String();
+      }
+
+      if (!c.Done()) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateScope(name, body.value(), deps).get();
+    }
+
+    case QAST_BLOCK: {
+      auto items = Nodes(c);
+      if (!c.Done() || scalar > static_cast<uint16_t>(BlockMode::Unsafe)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateBlock(items, static_cast<BlockMode>(scalar)).get();
+    }
+
+    case QAST_EXPORT: {
+      auto abi_name = c.String();
+      auto body = c.Node();
+      auto attributes = Nodes(c);
+      if (!c.Done() || scalar > static_cast<uint16_t>(Vis::Pro)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateExport(body.value(), attributes, static_cast<Vis>(scalar), abi_name).get();
+    }
+
+    case QAST_VAR: {
+      auto name = c.String();
+      auto type = c.Maybe<Type>();
+      auto init = c.Maybe();
+      auto attributes = Nodes(c);
+      if (!c.Done() || scalar > static_cast<uint16_t>(VariableType::Let)) [[unlikely]] {
+        return nullptr;
+      }
+
+      return m_fac.CreateVariable(static_cast<VariableType>(scalar), name, attributes, type, init).get();
+    }
+
+    case QAST_FUNCTION: {
+      auto name = c.String();
+      auto return_type = c.Node<Type>();
+      auto precond = c.Maybe();
+      auto postcond = c.Maybe();
+      auto body = c.Maybe();
+      auto attributes = Nodes(c);
+
+      std::vector<std::pair<string, bool>> captures;
+      auto count = c.Count();
+      captures.reserve(count);
+      for (uint32_t i = 0; i < count && c.Ok(); ++i) {
+        auto capture_name = c.String();
+        auto is_ref = c.Value();
+        if (is_ref > 1) [[unlikely]] {
+          c.Fail();
+        }
+        captures.emplace_back(capture_name, is_ref != 0);
+      }
+
+      std::vector<ASTFactory::FactoryFunctionParameter> params;
+      for (const auto &[param_name, type, default_value] : Params(c)) {
+        params.emplace_back(param_name, type, default_value);
+      }
+
+      auto template_params = TemplateParams(c);
+      if (!c.Done() || !IsPurityAndVariadic(scalar)) [[unlikely]] {
+        return nullptr;
+      }
+
+      auto object =
+          m_fac.CreateFunction(name, return_type.value(), params, (scalar >> 8) != 0, body,
+                               static_cast<Purity>(scalar & 0xff), attributes, precond, postcond, captures,
+                               template_params);
+      return object.has_value() ? object.value().get() : nullptr;
+    }
+
+    default: {
+      return nullptr;
+    }
+  }
+}
+
+auto FlatDecoder::Run() -> NullableFlowPtr<Expr> {
+  for (uint32_t offset = 0; offset < m_ast.NodesSize();) {
+    auto node = m_ast.At(offset);
+
+    auto *object = Decode(node);
+    if (object == nullptr) [[unlikely]] {
+      return nullptr;
+    }
+
+    object->SetMock(node.IsMock());
+    if (auto count = node.CommentCount(); count != 0) {
+      std::vector<string> comments;
+      comments.reserve(count);
+      for (uint32_t i = 0; i < count; ++i) {
+        comments.push_back(Intern(node.GetCommentId(i)));
+      }
+      object->SetComments(comments);
+    }
+
+    m_nodes[offset / 4] = object;
+    offset += node.GetSize() * 4;
+  }
+
+  return m_nodes[m_ast.Root().GetOffset() / 4];
+}
+
+FlatAstReader::FlatAstReader(std::string_view flat_data, std::pmr::memory_resource &pool) {
+  auto ast = FlatAst::Open(flat_data);
+  if (!ast.has_value()) [[unlikely]] {
+    return;
+  }
+
+  ASTExtensionScope extension_scope(pool);
+  m_root = FlatDecoder(ast.value(), pool).Run();
+}
+
+auto FlatAstReader::Get() -> NullableFlowPtr<Expr> { return m_root; }
@@ -30,486 +30,357 @@
 ///   <https://www.gnu.org/licenses/>.                                       ///
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
-
-#include <algorithm>
-#include <nitrate-core/Logger.hh>
+#include <nitrate-core/Assert.hh>
 #include <nitrate-core/Macro.hh>
-#include <nitrate-lexer/Scanner.hh>
 #include <nitrate-parser/AST.hh>
 #include <nitrate-parser/ASTBase.hh>
 #include <nitrate-parser/ASTExpr.hh>
 #include <nitrate-parser/ASTStmt.hh>
 #include <nitrate-parser/ASTType.hh>
-#include <nitrate-parser/ASTVisitor.hh>
-#include <nitrate-parser/ASTWriter.hh>
 #include <nitrate-parser/Algorithm.hh>
-#include <queue>
-#include <ranges>
-#include <stack>
+#include <variant>
 
 using namespace ncc;
 using namespace ncc::parse;
 
-class IterVisitor : public ASTVisitor {
-  std::vector<FlowPtr<Expr>>& m_sub;
+namespace {
+  class ChildCollector final {
+    detail::ChildList &m_sub;
 
-  template <class T>
-  constexpr void Add(FlowPtr<T> n) {
-    if (n == nullptr) {
-      return;
-    }
+  public:
+    ChildCollector(detail::ChildList &children) : m_sub(children) {}
 
-    m_sub.push_back(n);
-  }
+    template <class T>
+    void Add(FlowPtr<T> n) {
+      if (n == nullptr) {
+        return;
+      }
 
-  template <class T>
-  constexpr void Add(NullableFlowPtr<T> n) {
-    if (!n.has_value() || n == nullptr) {
-      return;
+      m_sub.push_back(n);
     }
 
-    m_sub.push_back(n.value());
-  }
-
-  void AddTypesuffix(const FlowPtr<Type>& n) {
-    Add(n->GetWidth());
-    Add(n->GetRangeBegin());
-    Add(n->GetRangeEnd());
-  }
-
-  void Visit(FlowPtr<NamedTy> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<InferTy> n) override { AddTypesuffix(n); }
-
-  void Visit(FlowPtr<TemplateType> n) override {
-    Add(n->GetTemplate());
-    std::for_each(n->GetArgs().begin(), n->GetArgs().end(), [&](auto arg) { Add(arg.second); });
-
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<U1> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<U8> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<U16> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<U32> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<U64> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<U128> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<I8> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<I16> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<I32> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<I64> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<I128> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<F16> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<F32> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<F64> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<F128> n) override { AddTypesuffix(n); }
-  void Visit(FlowPtr<VoidTy> n) override { AddTypesuffix(n); }
-
-  void Visit(FlowPtr<PtrTy> n) override {
-    Add(n->GetItem());
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<OpaqueTy> n) override { AddTypesuffix(n); }
-
-  void Visit(FlowPtr<TupleTy> n) override {
-    std::for_each(n->GetItems().begin(), n->GetItems().end(), [&](auto item) { Add(item); });
-
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<ArrayTy> n) override {
-    Add(n->GetItem());
-    Add(n->GetSize());
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<RefTy> n) override {
-    Add(n->GetItem());
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<FuncTy> n) override {
-    std::for_each(n->GetAttributes().begin(), n->GetAttributes().end(), [&](auto attr) { Add(attr); });
-
-    std::for_each(n->GetParams().begin(), n->GetParams().end(), [&](auto param) {
-      Add(std::get<1>(param));
-      std::get<2>(param);
-    });
-
-    Add(n->GetReturn());
-
-    AddTypesuffix(n);
-  }
-
-  void Visit(FlowPtr<Unary> n) override { Add(n->GetRHS()); }
-
-  void Visit(FlowPtr<Binary> n) override {
-    Add(n->GetLHS());
-    Add(n->GetRHS());
-  }
-
-  void Visit(FlowPtr<PostUnary> n) override { Add(n->GetLHS()); }
-
-  void Visit(FlowPtr<Ternary> n) override {
-    Add(n->GetCond());
-    Add(n->GetLHS());
-    Add(n->GetRHS());
-  }
-
-  void Visit(FlowPtr<Integer>) override {}
-  void Visit(FlowPtr<Float>) override {}
-  void Visit(FlowPtr<Boolean>) override {}
-  void Visit(FlowPtr<parse::String>) override {}
-  void Visit(FlowPtr<Character>) override {}
-  void Visit(FlowPtr<Null>) override {}
-  void Visit(FlowPtr<Undefined>) override {}
-
-  void Visit(FlowPtr<Call> n) override {
-    Add(n->GetFunc());
-    std::for_each(n->GetArgs().begin(), n->GetArgs().end(), [&](auto arg) { Add(arg.second); });
-  }
-
-  void Visit(FlowPtr<TemplateCall> n) override {
-    Add(n->GetFunc());
-    std::for_each(n->GetTemplateArgs().begin(), n->GetTemplateArgs().end(), [&](auto arg) { Add(arg.second); });
-
-    std::for_each(n->GetArgs().begin(), n->GetArgs().end(), [&](auto arg) { Add(arg.second); });
-  }
-
-  void Visit(FlowPtr<List> n) override {
-    std::for_each(n->GetItems().begin(), n->GetItems().end(), [&](auto item) { Add(item); });
-  }
-
-  void Visit(FlowPtr<Assoc> n) override {
-    Add(n->GetKey());
-    Add(n->GetValue());
-  }
-
-  void Visit(FlowPtr<Index> n) override {
-    Add(n->GetBase());
-    Add(n->GetIndex());
-  }
-
-  void Visit(FlowPtr<Slice> n) override {
-    Add(n->GetBase());
-    Add(n->GetStart());
-    Add(n->GetEnd());
-  }
-
-  void Visit(FlowPtr<FString> n) override {
-    std::for_each(n->GetItems().begin(), n->GetItems().end(), [&](auto arg) {
-      if (std::holds_alternative<FlowPtr<Expr>>(arg)) {
-        Add(std::get<FlowPtr<Expr>>(arg));
-      } else {
-        qcore_assert(std::holds_alternative<string>(arg));
+    template <class T>
+    void Add(NullableFlowPtr<T> n) {
+      if (!n.has_value() || n == nullptr) {
+        return;
       }
-    });
-  }
-
-  void Visit(FlowPtr<Identifier>) override {}
-
-  void Visit(FlowPtr<Sequence> n) override {
-    std::for_each(n->GetItems().begin(), n->GetItems().end(), [&](auto item) { Add(item); });
-  }
 
-  void Visit(FlowPtr<Block> n) override {
-    std::for_each(n->GetStatements().begin(), n->GetStatements().end(), [&](auto item) { Add(item); });
-  }
-
-  void Visit(FlowPtr<Variable> n) override {
-    std::for_each(n->GetAttributes().begin(), n->GetAttributes().end(), [&](auto attr) { Add(attr); });
-
-    Add(n->GetType());
-    Add(n->GetInitializer());
-  }
-
-  void Visit(FlowPtr<Assembly> n) override {
-    std::for_each(n->GetArguments().begin(), n->GetArguments().end(), [&](auto arg) { Add(arg); });
-  }
-
-  void Visit(FlowPtr<If> n) override {
-    Add(n->GetCond());
-    Add(n->GetThen());
-    Add(n->GetElse());
-  }
-
-  void Visit(FlowPtr<While> n) override {
-    Add(n->GetCond());
-    Add(n->GetBody());
-  }
-
-  void Visit(FlowPtr<For> n) override {
-    Add(n->GetInit());
-    Add(n->GetCond());
-    Add(n->GetStep());
-    Add(n->GetBody());
-  }
-
-  void Visit(FlowPtr<Foreach> n) override {
-    Add(n->GetExpr());
-    Add(n->GetBody());
-  }
-
-  void Visit(FlowPtr<Break>) override {}
-  void Visit(FlowPtr<Continue>) override {}
-  void Visit(FlowPtr<Return> n) override { Add(n->GetValue()); }
-
-  void Visit(FlowPtr<ReturnIf> n) override {
-    Add(n->GetCond());
-    Add(n->GetValue());
-  }
-
-  void Visit(FlowPtr<Case> n) override {
-    Add(n->GetCond());
-    Add(n->GetBody());
-  }
-
-  void Visit(FlowPtr<Switch> n) override {
-    Add(n->GetCond());
-    std::for_each(n->GetCases().begin(), n->GetCases().end(), [&](auto c) { Add(c); });
-    Add(n->GetDefault());
-  }
-
-  void Visit(FlowPtr<Typedef> n) override { Add(n->GetType()); }
-
-  void Visit(FlowPtr<Function> n) override {
-    std::for_each(n->GetAttributes().begin(), n->GetAttributes().end(), [&](auto attr) { Add(attr); });
-
-    if (n->GetTemplateParams()) {
-      std::for_each(n->GetTemplateParams()->begin(), n->GetTemplateParams()->end(), [&](auto param) {
-        Add(std::get<1>(param));
-        Add(std::get<2>(param));
-      });
+      m_sub.push_back(n.value());
     }
 
-    std::for_each(n->GetParams().begin(), n->GetParams().end(), [&](auto param) {
-      Add(std::get<1>(param));
-      std::get<2>(param);
-    });
-
-    Add(n->GetReturn());
-    Add(n->GetPrecond());
-    Add(n->GetPostcond());
-    Add(n->GetBody());
-  }
-
-  void Visit(FlowPtr<Struct> n) override {
-    std::for_each(n->GetAttributes().begin(), n->GetAttributes().end(), [&](auto attr) { Add(attr); });
-
-    if (n->GetTemplateParams()) {
-      std::for_each(n->GetTemplateParams()->begin(), n->GetTemplateParams()->end(), [&](auto param) {
-        Add(std::get<1>(param));
-        Add(std::get<2>(param));
-      });
+    template <class Range, class Project>
+    void AddEach(const Range &items, Project project) {
+      for (const auto &item : items) {
+        Add(project(item));
+      }
     }
 
-    std::for_each(n->GetFields().begin(), n->GetFields().end(), [&](auto field) {
-      Add(field.GetType());
-      Add(field.GetValue());
-    });
-
-    std::for_each(n->GetMethods().begin(), n->GetMethods().end(), [&](auto method) { Add(method.m_func); });
+    template <class Range>
+    void AddEach(const Range &items) {
+      for (const auto &item : items) {
+        Add(item);
+      }
+    }
 
-    std::for_each(n->GetStaticMethods().begin(), n->GetStaticMethods().end(), [&](auto method) { Add(method.m_func); });
-  }
+    void AddTypeSuffix(const Type *n) {
+      Add(n->GetWidth());
+      Add(n->GetRangeBegin());
+      Add(n->GetRangeEnd());
+    }
+  };
 
-  void Visit(FlowPtr<Enum> n) override {
-    Add(n->GetType());
+  constexpr auto kSecond = [](const auto &pair) { return pair.second; };
+  constexpr auto kParamType = [](const auto &param) { return std::get<1>(param); };
+  constexpr auto kParamDefault = [](const auto &param) { return std::get<2>(param); };
+}  // namespace
 
-    std::for_each(n->GetFields().begin(), n->GetFields().end(), [&](auto item) { Add(item.second); });
+NCC_EXPORT void detail::GetChildren(const FlowPtr<Expr> &base, ChildList &children) {
+  if (!base) [[unlikely]] {
+    return;
   }
 
-  void Visit(FlowPtr<Scope> n) override { Add(n->GetBody()); }
-
-  void Visit(FlowPtr<Export> n) override {
-    std::for_each(n->GetAttributes().begin(), n->GetAttributes().end(), [&](auto attr) { Add(attr); });
-
-    Add(n->GetBody());
-  }
+  ChildCollector c(children);
+  Expr *n = base.get();
 
-public:
-  IterVisitor(std::vector<FlowPtr<Expr>>& children) : m_sub(children) {}
-};
+  switch (n->GetKind()) {
+    case QAST_BINEXPR: {
+      c.Add(n->As<Binary>()->GetLHS());
+      c.Add(n->As<Binary>()->GetRHS());
+      break;
+    }
 
-static NCC_FORCE_INLINE void GetChildrenSorted(FlowPtr<Expr> base, std::vector<FlowPtr<Expr>>& children) {
-  children.clear();
+    case QAST_UNEXPR: {
+      c.Add(n->As<Unary>()->GetRHS());
+      break;
+    }
 
-  if (!base) [[unlikely]] {
-    return;
-  }
+    case QAST_POST_UNEXPR: {
+      c.Add(n->As<PostUnary>()->GetLHS());
+      break;
+    }
 
-  IterVisitor v(children);
-  base.Accept(v);
-}
+    case QAST_TEREXPR: {
+      c.Add(n->As<Ternary>()->GetCond());
+      c.Add(n->As<Ternary>()->GetLHS());
+      c.Add(n->As<Ternary>()->GetRHS());
+      break;
+    }
 
-NCC_EXPORT void detail::DfsPreImpl(const FlowPtr<Expr>& base, const IterCallback& cb) {
-  auto syncfn = [](const FlowPtr<Expr>& n, const IterCallback& cb) {
-    std::stack<std::pair<NullableFlowPtr<Expr>, FlowPtr<Expr>>> s;
-    std::vector<FlowPtr<Expr>> children;
+    case QAST_INT:
+    case QAST_FLOAT:
+    case QAST_STRING:
+    case QAST_CHAR:
+    case QAST_BOOL:
+    case QAST_NULL:
+    case QAST_UNDEF:
+    case QAST_IDENT:
+    case QAST_BREAK:
+    case QAST_CONTINUE: {
+      break;
+    }
 
-    s.emplace(nullptr, n);
+    case QAST_CALL: {
+      c.Add(n->As<Call>()->GetFunc());
+      c.AddEach(n->As<Call>()->GetArgs(), kSecond);
+      break;
+    }
 
-    while (!s.empty()) {
-      auto cur = s.top();
-      s.pop();
+    case QAST_TEMPL_CALL: {
+      c.Add(n->As<TemplateCall>()->GetFunc());
+      c.AddEach(n->As<TemplateCall>()->GetTemplateArgs(), kSecond);
+      c.AddEach(n->As<TemplateCall>()->GetArgs(), kSecond);
+      break;
+    }
 
-      bool skip = false;
+    case QAST_LIST: {
+      c.AddEach(n->As<List>()->GetItems());
+      break;
+    }
 
-      switch (cb(cur.first, cur.second)) {
-        case IterOp::Proceed: {
-          break;
-        }
+    case QAST_ASSOC: {
+      c.Add(n->As<Assoc>()->GetKey());
+      c.Add(n->As<Assoc>()->GetValue());
+      break;
+    }
 
-        case IterOp::Abort:
-          [[unlikely]] { return; }
+    case QAST_INDEX: {
+      c.Add(n->As<Index>()->GetBase());
+      c.Add(n->As<Index>()->GetIndex());
+      break;
+    }
 
-        case IterOp::SkipChildren: {
-          skip = true;
-          break;
-        }
-      }
+    case QAST_SLICE: {
+      c.Add(n->As<Slice>()->GetBase());
+      c.Add(n->As<Slice>()->GetStart());
+      c.Add(n->As<Slice>()->GetEnd());
+      break;
+    }
 
-      if (!skip) [[likely]] {
-        GetChildrenSorted(cur.second, children);
-        for (auto& it : std::ranges::reverse_view(children)) {
-          s.emplace(cur.second, it);
+    case QAST_FSTRING: {
+      for (const auto &item : n->As<FString>()->GetItems()) {
+        if (std::holds_alternative<FlowPtr<Expr>>(item)) {
+          c.Add(std::get<FlowPtr<Expr>>(item));
         }
       }
+      break;
     }
-  };
 
-  syncfn(base, cb);
-}
-
-NCC_EXPORT void detail::DfsPostImpl(const FlowPtr<Expr>& base, const IterCallback& cb) {
-  auto syncfn = [](const FlowPtr<Expr>& n, const IterCallback& cb) {
-    std::stack<std::pair<NullableFlowPtr<Expr>, FlowPtr<Expr>>> s;
-    std::vector<FlowPtr<Expr>> children;
+    case QAST_SEQ: {
+      c.AddEach(n->As<Sequence>()->GetItems());
+      break;
+    }
 
-    s.emplace(nullptr, n);
+    case QAST_U1:
+    case QAST_U8:
+    case QAST_U16:
+    case QAST_U32:
+    case QAST_U64:
+    case QAST_U128:
+    case QAST_I8:
+    case QAST_I16:
+    case QAST_I32:
+    case QAST_I64:
+    case QAST_I128:
+    case QAST_F16:
+    case QAST_F32:
+    case QAST_F64:
+    case QAST_F128:
+    case QAST_VOID:
+    case QAST_INFER:
+    case QAST_OPAQUE:
+    case QAST_NAMED: {
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-    while (!s.empty()) {
-      auto cur = s.top();
-      s.pop();
+    case QAST_REF: {
+      c.Add(n->As<RefTy>()->GetItem());
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-      GetChildrenSorted(cur.second, children);
-      for (auto& it : std::ranges::reverse_view(children)) {
-        s.emplace(cur.second, it);
-      }
+    case QAST_PTR: {
+      c.Add(n->As<PtrTy>()->GetItem());
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-      switch (cb(cur.first, cur.second)) {
-        case IterOp::Proceed: {
-          break;
-        }
+    case QAST_ARRAY: {
+      c.Add(n->As<ArrayTy>()->GetItem());
+      c.Add(n->As<ArrayTy>()->GetSize());
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-        case IterOp::Abort:
-          [[unlikely]] { return; }
+    case QAST_TUPLE: {
+      c.AddEach(n->As<TupleTy>()->GetItems());
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-        case IterOp::SkipChildren: {
-          qcore_panic("dfs_post_impl: IterOp::SkipChildren not supported");
-        }
-      }
+    case QAST_TEMPLATE: {
+      c.Add(n->As<TemplateType>()->GetTemplate());
+      c.AddEach(n->As<TemplateType>()->GetArgs(), kSecond);
+      c.AddTypeSuffix(n->As<Type>());
+      break;
     }
-  };
 
-  syncfn(base, cb);
-  cb(nullptr, base);
-}
+    case QAST_FUNCTOR: {
+      c.AddEach(n->As<FuncTy>()->GetAttributes());
+      c.AddEach(n->As<FuncTy>()->GetParams(), kParamType);
+      c.Add(n->As<FuncTy>()->GetReturn());
+      c.AddTypeSuffix(n->As<Type>());
+      break;
+    }
 
-NCC_EXPORT void detail::BfsPreImpl(const FlowPtr<Expr>& base, const IterCallback& cb) {
-  auto syncfn = [](const FlowPtr<Expr>& n, const IterCallback& cb) {
-    std::queue<std::pair<NullableFlowPtr<Expr>, FlowPtr<Expr>>> s;
-    std::vector<FlowPtr<Expr>> children;
+    case QAST_IF: {
+      c.Add(n->As<If>()->GetCond());
+      c.Add(n->As<If>()->GetThen());
+      c.Add(n->As<If>()->GetElse());
+      break;
+    }
 
-    s.emplace(nullptr, n);
+    case QAST_RETIF: {
+      c.Add(n->As<ReturnIf>()->GetCond());
+      c.Add(n->As<ReturnIf>()->GetValue());
+      break;
+    }
 
-    while (!s.empty()) {
-      auto cur = s.front();
-      s.pop();
+    case QAST_SWITCH: {
+      c.Add(n->As<Switch>()->GetCond());
+      c.AddEach(n->As<Switch>()->GetCases());
+      c.Add(n->As<Switch>()->GetDefault());
+      break;
+    }
 
-      bool skip = false;
+    case QAST_CASE: {
+      c.Add(n->As<Case>()->GetCond());
+      c.Add(n->As<Case>()->GetBody());
+      break;
+    }
 
-      switch (cb(cur.first, cur.second)) {
-        case IterOp::Proceed: {
-          break;
-        }
+    case QAST_RETURN: {
+      c.Add(n->As<Return>()->GetValue());
+      break;
+    }
 
-        case IterOp::Abort:
-          [[unlikely]] { return; }
+    case QAST_WHILE: {
+      c.Add(n->As<While>()->GetCond());
+      c.Add(n->As<While>()->GetBody());
+      break;
+    }
 
-        case IterOp::SkipChildren: {
-          skip = true;
-          break;
-        }
-      }
+    case QAST_FOR: {
+      c.Add(n->As<For>()->GetInit());
+      c.Add(n->As<For>()->GetCond());
+      c.Add(n->As<For>()->GetStep());
+      c.Add(n->As<For>()->GetBody());
+      break;
+    }
 
-      if (!skip) [[likely]] {
-        GetChildrenSorted(cur.second, children);
-        for (auto& it : std::ranges::reverse_view(children)) {
-          s.emplace(cur.second, it);
-        }
-      }
+    case QAST_FOREACH: {
+      c.Add(n->As<Foreach>()->GetExpr());
+      c.Add(n->As<Foreach>()->GetBody());
+      break;
     }
-  };
 
-  syncfn(base, cb);
-}
+    case QAST_INLINE_ASM: {
+      c.AddEach(n->As<Assembly>()->GetArguments());
+      break;
+    }
 
-NCC_EXPORT void detail::BfsPostImpl(const FlowPtr<Expr>& base, const IterCallback& cb) {
-  auto syncfn = [](const FlowPtr<Expr>& n, const IterCallback& cb) {
-    std::queue<std::pair<NullableFlowPtr<Expr>, FlowPtr<Expr>>> s;
-    std::vector<FlowPtr<Expr>> children;
+    case QAST_TYPEDEF: {
+      c.Add(n->As<Typedef>()->GetType());
+      break;
+    }
 
-    s.emplace(nullptr, n);
+    case QAST_STRUCT: {
+      const auto *s = n->As<Struct>();
 
-    while (!s.empty()) {
-      auto cur = s.front();
-      s.pop();
+      c.AddEach(s->GetAttributes());
+      if (const auto params = s->GetTemplateParams()) {
+        for (const auto &param : params.value()) {
+          c.Add(kParamType(param));
+          c.Add(kParamDefault(param));
+        }
+      }
 
-      GetChildrenSorted(cur.second, children);
-      for (auto& it : std::ranges::reverse_view(children)) {
-        s.emplace(cur.second, it);
+      for (const auto &field : s->GetFields()) {
+        c.Add(field.GetType());
+        c.Add(field.GetValue());
       }
 
-      switch (cb(cur.first, cur.second)) {
-        case IterOp::Proceed: {
-          break;
-        }
+      c.AddEach(s->GetMethods(), [](const auto &method) { return method.m_func; });
+      c.AddEach(s->GetStaticMethods(), [](const auto &method) { return method.m_func; });
+      break;
+    }
 
-        case IterOp::Abort:
-          [[unlikely]] { return; }
+    case QAST_ENUM: {
+      c.Add(n->As<Enum>()->GetType());
+      c.AddEach(n->As<Enum>()->GetFields(), kSecond);
+      break;
+    }
 
-        case IterOp::SkipChildren: {
-          qcore_panic("bfs_post_impl: IterOp::SkipChildren not supported");
-        }
-      }
+    case QAST_SCOPE: {
+      c.Add(n->As<Scope>()->GetBody());
+      break;
     }
-  };
 
-  syncfn(base, cb);
-}
+    case QAST_BLOCK: {
+      c.AddEach(n->As<Block>()->GetStatements());
+      break;
+    }
 
-NCC_EXPORT void detail::IterChildren(const FlowPtr<Expr>& base, const IterCallback& cb) {
-  auto syncfn = [](const FlowPtr<Expr>& n, const IterCallback& cb) {
-    std::vector<FlowPtr<Expr>> children;
-    GetChildrenSorted(n, children);
+    case QAST_EXPORT: {
+      c.AddEach(n->As<Export>()->GetAttributes());
+      c.Add(n->As<Export>()->GetBody());
+      break;
+    }
 
-    for (const FlowPtr<Expr>& child : children) {
-      switch (cb(n, child)) {
-        case IterOp::Proceed: {
-          break;
-        }
+    case QAST_VAR: {
+      c.AddEach(n->As<Variable>()->GetAttributes());
+      c.Add(n->As<Variable>()->GetType());
+      c.Add(n->As<Variable>()->GetInitializer());
+      break;
+    }
 
-        case IterOp::Abort: {
-          return;
-        }
+    case QAST_FUNCTION: {
+      const auto *f = n->As<Function>();
 
-        case IterOp::SkipChildren: {
-          return;
+      c.AddEach(f->GetAttributes());
+      if (const auto params = f->GetTemplateParams()) {
+        for (const auto &param : params.value()) {
+          c.Add(kParamType(param));
+          c.Add(kParamDefault(param));
         }
       }
-    }
-  };
 
-  syncfn(base, cb);
+      c.AddEach(f->GetParams(), kParamType);
+      c.Add(f->GetReturn());
+      c.Add(f->GetPrecond());
+      c.Add(f->GetPostcond());
+      c.Add(f->GetBody());
+      break;
+    }
+  }
 }
@@ -33,6 +33,9 @@
 
 #include <core/SyntaxTree.pb.h>
 #include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <nitrate-core/Logger.hh>
@@ -2420,9 +2423,98 @@ AstReader::AstReader(std::string_view protobuf_data, std::pmr::memory_resource &
     return;
   }
 
+  ASTExtensionScope extension_scope(pool);
   m_root = Unmarshal(root);
 }
 
+AstReader::AstReader(std::istream &protobuf_stream, std::pmr::memory_resource &pool,
+                     ReaderSourceManager source_manager)
+    : m_rd(source_manager), m_fac(pool) {
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::IstreamInputStream raw_input(&protobuf_stream);
+  ASTExtensionScope extension_scope(pool);
+
+  SyntaxTree::Block block_header;
+  SyntaxTree::Expr other_root;
+  std::vector<FlowPtr<Expr>> statements;
+  bool is_block = false;
+
+  while (true) {
+    /* A fresh coded stream per field keeps the total byte limit per field */
+    google::protobuf::io::CodedInputStream input(&raw_input);
+    input.SetRecursionLimit(kRecursionLimit);
+
+    const auto tag = input.ReadTag();
+    if (tag == 0) {
+      break;
+    }
+
+    uint32_t size = 0;
+    if (WireFormatLite::GetTagWireType(tag) != WireFormatLite::WIRETYPE_LENGTH_DELIMITED ||
+        !input.ReadVarint32(&size)) [[unlikely]] {
+      return;
+    }
+
+    if (WireFormatLite::GetTagFieldNumber(tag) != SyntaxTree::Expr::kBlockFieldNumber) {
+      std::string bytes;
+      std::string field;
+      if (!input.ReadString(&bytes, size)) [[unlikely]] {
+        return;
+      }
+
+      {
+        google::protobuf::io::StringOutputStream field_stream(&field);
+        google::protobuf::io::CodedOutputStream output(&field_stream);
+        output.WriteTag(tag);
+        output.WriteVarint32(size);
+        output.WriteString(bytes);
+      }
+
+      if (!other_root.MergeFromString(field)) [[unlikely]] {
+        return;
+      }
+
+      continue;
+    }
+
+    const auto limit = input.PushLimit(size);
+    SyntaxTree::Block frame;
+    if (!frame.ParseFromCodedStream(&input)) [[unlikely]] {
+      return;
+    }
+    input.PopLimit(limit);
+
+    for (const auto &statement : frame.statements()) {
+      auto object = Unmarshal(statement);
+      if (!object.has_value()) [[unlikely]] {
+        return;
+      }
+
+      statements.push_back(object.value());
+    }
+
+    frame.clear_statements();
+    block_header.MergeFrom(frame);
+    is_block = true;
+  }
+
+  if (!is_block) {
+    m_root = Unmarshal(other_root);
+    return;
+  }
+
+  if (other_root.node_case() != SyntaxTree::Expr::NODE_NOT_SET) [[unlikely]] {
+    return;
+  }
+
+  auto object = m_fac.CreateBlock(statements, FromBlockMode(block_header.safety()));
+  UnmarshalLocationLocation(block_header.location(), object);
+  UnmarshalCodeComment(block_header.comments(), object);
+
+  m_root = object;
+}
+
 auto AstReader::Get() -> NullableFlowPtr<Expr> {
   if (!m_root.has_value()) [[unlikely]] {
     return std::nullopt;
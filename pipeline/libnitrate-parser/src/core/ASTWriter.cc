@@ -257,6 +257,19 @@ static SyntaxTree::FunctionPurity FromPurity(ncc::parse::Purity purity) {
   }
 }
 
+static SyntaxTree::Block_Safety FromSafety(ncc::parse::BlockMode mode) {
+  switch (mode) {
+    case ncc::parse::BlockMode::Unknown:
+      return SyntaxTree::Block_Safety_None;
+
+    case ncc::parse::BlockMode::Safe:
+      return SyntaxTree::Block_Safety_Safe;
+
+    case ncc::parse::BlockMode::Unsafe:
+      return SyntaxTree::Block_Safety_Unsafe;
+  }
+}
+
 static SyntaxTree::Struct_AggregateKind FromStructKind(ncc::parse::CompositeType type) {
   switch (type) {
     case ncc::parse::CompositeType::Struct:
@@ -1336,23 +1349,7 @@ SyntaxTree::Block *AstWriter::From(const FlowPtr<Block> &in) {
   auto *message = Pool::CreateMessage<SyntaxTree::Block>(m_arena);
 
   message->set_allocated_location(FromSource(in));
-
-  switch (in->GetSafety()) {
-    case BlockMode::Unknown: {
-      message->set_safety(SyntaxTree::Block_Safety_None);
-      break;
-    }
-
-    case BlockMode::Safe: {
-      message->set_safety(SyntaxTree::Block_Safety_Safe);
-      break;
-    }
-
-    case BlockMode::Unsafe: {
-      message->set_safety(SyntaxTree::Block_Safety_Unsafe);
-      break;
-    }
-  }
+  message->set_safety(FromSafety(in->GetSafety()));
 
   { /* Add all statements */
     const auto &items = in->GetStatements();
@@ -1886,7 +1883,36 @@ void AstWriter::Visit(FlowPtr<Slice> n) { SEND(From(n), slice); }
 void AstWriter::Visit(FlowPtr<FString> n) { SEND(From(n), fstring); }
 void AstWriter::Visit(FlowPtr<Identifier> n) { SEND(From(n), identifier); }
 void AstWriter::Visit(FlowPtr<Sequence> n) { SEND(From(n), sequence); }
-void AstWriter::Visit(FlowPtr<Block> n) { SEND(From(n), block); }
+void AstWriter::Visit(FlowPtr<Block> n) {
+  if (m_plaintext_mode) [[unlikely]] {
+    SEND(From(n), block);
+    return;
+  }
+
+  /* The root block is written as one `block` field per statement. Parsers
+   * merge repeated occurrences of a message field and append the repeated
+   * statements, so the output decodes to the same tree as a single message,
+   * but the arena never holds more than one encoded statement. */
+  const auto statements = n->GetStatements();
+  for (size_t i = 0; i == 0 || i < statements.size(); i++) {
+    auto *frame = Pool::CreateMessage<SyntaxTree::Block>(m_arena);
+    frame->set_safety(FromSafety(n->GetSafety()));
+    if (i == 0) {
+      frame->set_allocated_location(FromSource(n));
+    }
+    if (i < statements.size()) {
+      frame->mutable_statements()->AddAllocated(From(statements[i]));
+    }
+
+    auto *root = Pool::CreateMessage<SyntaxTree::Expr>(m_arena);
+    root->set_allocated_block(frame);
+    if (!root->SerializeToOstream(&m_os)) [[unlikely]] {
+      qcore_panic("Failed to serialize protobuf message");
+    }
+
+    m_arena->Reset();
+  }
+}
 void AstWriter::Visit(FlowPtr<Variable> n) { SEND(From(n), variable); }
 void AstWriter::Visit(FlowPtr<Assembly> n) { SEND(From(n), assembly); }
 void AstWriter::Visit(FlowPtr<If> n) { SEND(From(n), if_); }
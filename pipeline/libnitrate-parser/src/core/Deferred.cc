@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <core/TokenReplay.hh>
+#include <descent/Recurse.hh>
+#include <nitrate-parser/Algorithm.hh>
+#include <nitrate-parser/Context.hh>
+
+using namespace ncc;
+using namespace ncc::parse;
+using namespace ncc::lex;
+
+void ParserSetCurrentScanner(IScanner *scanner);
+
+auto GeneralParser::PImpl::DeferFunctionBody() -> std::optional<std::vector<Token>> {
+  if (!m_lazy_bodies || !Peek().Is<PuncLCur>()) {
+    return std::nullopt;
+  }
+
+  std::vector<Token> tokens;
+  size_t depth = 0;
+
+  /* Comments are kept so that the body binds them once it is parsed */
+  const auto old_state = m_rd.SkipCommentsState(false);
+
+  do {
+    auto tok = Peek();
+    if (tok.Is(EofF)) [[unlikely]] {
+      Log << SyntaxError << Current() << "Expected '}'";
+      break;
+    }
+
+    tokens.push_back(Next());
+
+    if (tok.Is<PuncLCur>()) {
+      ++depth;
+    } else if (tok.Is<PuncRCur>()) {
+      --depth;
+    }
+  } while (depth != 0);
+
+  m_rd.SkipCommentsState(old_state);
+
+  return tokens;
+}
+
+auto GeneralParser::PImpl::DeferVariableValue() -> std::optional<std::vector<Token>> {
+  if (!m_lazy_bodies || !Peek().Is<OpSet>()) {
+    return std::nullopt;
+  }
+
+  std::vector<Token> tokens;
+  size_t depth = 0;
+  bool maybe_template = false;
+  bool ambiguous = false;
+
+  const auto old_state = m_rd.SkipCommentsState(false);
+
+  tokens.push_back(Next());
+
+  while (true) {
+    auto tok = Peek();
+    if (tok.Is(EofF)) [[unlikely]] {
+      break;
+    }
+
+    if (depth == 0 && (tok.Is<PuncSemi>() || tok.Is<PuncComa>())) {
+      /* In `x as Map<K, V>` the comma does not end the initializer */
+      ambiguous = tok.Is<PuncComa>() && maybe_template;
+      break;
+    }
+
+    if (tok.Is(Punc)) {
+      switch (tok.GetPunctor()) {
+        case PuncLPar:
+        case PuncLBrk:
+        case PuncLCur: {
+          ++depth;
+          break;
+        }
+
+        case PuncRPar:
+        case PuncRBrk:
+        case PuncRCur: {
+          ambiguous = depth == 0;
+          depth -= depth > 0 ? 1 : 0;
+          break;
+        }
+
+        default: {
+          break;
+        }
+      }
+    }
+
+    if (ambiguous) {
+      break;
+    }
+
+    maybe_template |= depth == 0 && tok.Is<OpLT>();
+    tokens.push_back(Next());
+  }
+
+  m_rd.SkipCommentsState(old_state);
+
+  /* Let the regular parser handle anything the skimming above can't delimit */
+  if (ambiguous || tokens.size() == 1) {
+    std::for_each(tokens.rbegin(), tokens.rend(), [&](auto tok) { m_rd.Insert(tok); });
+    return std::nullopt;
+  }
+
+  return tokens;
+}
+
+auto GeneralParser::SetLazyBodies(bool lazy) -> void {
+  if (!m_impl) {
+    qcore_panic("GeneralParser::SetLazyBodies() called on moved-from object");
+  }
+
+  m_impl->m_lazy_bodies = lazy;
+}
+
+auto GeneralParser::IsDeferred(const FlowPtr<Expr> &node) const -> bool {
+  return m_impl && m_impl->m_deferred.contains(node.get());
+}
+
+auto GeneralParser::Materialize(const FlowPtr<Expr> &node) -> bool {
+  if (!m_impl) {
+    qcore_panic("GeneralParser::Materialize() called on moved-from object");
+  }
+
+  auto it = m_impl->m_deferred.find(node.get());
+  if (it == m_impl->m_deferred.end()) {
+    return false;
+  }
+
+  const auto tokens = std::move(it->second);
+  m_impl->m_deferred.erase(it);
+
+  bool failed = false;
+
+  { /* Diagnostics refer to the scanner the tokens came from */
+    ParserSetCurrentScanner(&m_impl->m_rd);
+    ASTExtensionScope extension_scope(m_impl->m_pool);
+
+    auto sub_id = Log.Subscribe([&](const LogMessage &m) {
+      if (m.m_by.GetKind() == SyntaxError.GetKind()) {
+        failed = true;
+      }
+    });
+
+    TokenReplay replay(tokens, m_impl->m_rd);
+    replay.SkipCommentsState(true);
+
+    PImpl sub(replay, m_impl->m_env, m_impl->m_pool);
+    NullableFlowPtr<Expr> result;
+
+    if (node->Is(QAST_FUNCTION)) {
+      result = sub.RecurseFunctionBody(false);
+      node.As<Function>()->SetBody(result);
+    } else {
+      result = sub.RecurseVariableValue();
+      node.As<Variable>()->SetInitializer(result);
+    }
+
+    if (!replay.Peek().Is(EofF)) {
+      Log << SyntaxError << replay.Peek() << "Unexpected token after deferred expression";
+    }
+
+    if (result.has_value()) {
+      for_each<dfs_pre>(result.value(), [&](auto c) {
+        failed |= !c || c->IsMock();
+        return failed ? IterOp::Abort : IterOp::Proceed;
+      });
+    }
+
+    Log.Unsubscribe(sub_id);
+    ParserSetCurrentScanner(nullptr);
+  }
+
+  return !failed;
+}
@@ -32,6 +32,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cstring>
+#include <memory>
 #include <descent/Recurse.hh>
 #include <nitrate-core/Init.hh>
 #include <nitrate-core/Logger.hh>
@@ -54,26 +55,72 @@ NCC_EXPORT std::ostream &parse::operator<<(std::ostream &os, ASTNodeKind kind) {
   return os;
 }
 
-auto ASTExtension::Add(lex::LocationID begin, lex::LocationID end) -> ASTExtensionKey {
-  SmartLock lock(m_mutex);
+static thread_local std::pmr::memory_resource *CurrentPool = nullptr;
 
-  m_pairs.push_back({begin, end});
+auto ASTExtension::Allocate(std::pmr::memory_resource &pool, size_t size, size_t align) -> void * {
+  if (&pool == &m_fallback) [[unlikely]] {
+    SmartLock lock(m_mutex);
+    return pool.allocate(size, align);
+  }
 
-  return {m_pairs.size() - 1};
+  return pool.allocate(size, align);
 }
 
-auto ASTExtension::Get(ASTExtensionKey loc) -> const ASTExtensionPackage & {
-  SmartLock lock(m_mutex);
+auto ASTExtension::Create(lex::LocationID begin, lex::LocationID end, std::pmr::memory_resource &pool)
+    -> ASTExtensionKey {
+  auto *record = new (Allocate(pool, sizeof(ASTExtensionPackage), alignof(ASTExtensionPackage)))
+      ASTExtensionPackage(begin, end, &pool);
+
+  const auto key = reinterpret_cast<uintptr_t>(record);
+  qcore_assert((key >> 56) == 0, "Extension record address does not fit into a key");
 
-  return m_pairs.at(loc.Key());
+  return {key};
 }
 
-void ASTExtension::Set(ASTExtensionKey id, ASTExtensionPackage &&data) {
+void ASTExtension::Reset() {
   SmartLock lock(m_mutex);
+  m_fallback.release();
+}
+
+auto ASTExtension::Add(lex::LocationID begin, lex::LocationID end) -> ASTExtensionKey {
+  return Add(begin, end, CurrentPool != nullptr ? *CurrentPool : m_fallback);
+}
+
+auto ASTExtension::Add(lex::LocationID begin, lex::LocationID end, std::pmr::memory_resource &pool)
+    -> ASTExtensionKey {
+  /* Most nodes built outside of the parser have no location at all */
+  if (!begin.HasValue() && !end.HasValue()) {
+    return {};
+  }
+
+  return Create(begin, end, pool);
+}
+
+void ASTExtension::AddComments(ASTExtensionKey &id, std::span<const string> comments) {
+  if (comments.empty()) {
+    return;
+  }
+
+  if (id.IsNull()) {
+    id = Create(lex::LocationID(), lex::LocationID(), CurrentPool != nullptr ? *CurrentPool : m_fallback);
+  }
+
+  auto &record = const_cast<ASTExtensionPackage &>(Get(id));
+  const auto count = record.m_comments.size() + comments.size();
+  auto *buffer = static_cast<string *>(Allocate(*record.m_pool, sizeof(string) * count, alignof(string)));
+
+  auto *end = std::uninitialized_copy(record.m_comments.begin(), record.m_comments.end(), buffer);
+  std::uninitialized_copy(comments.begin(), comments.end(), end);
 
-  m_pairs.at(id.Key()) = std::move(data);
+  record.m_comments = std::span<const string>(buffer, count);
 }
 
+ASTExtensionScope::ASTExtensionScope(std::pmr::memory_resource &pool) : m_previous(CurrentPool) {
+  CurrentPool = &pool;
+}
+
+ASTExtensionScope::~ASTExtensionScope() { CurrentPool = m_previous; }
+
 NCC_EXPORT auto parse::operator<<(std::ostream &os, const ASTExtensionKey &idx) -> std::ostream & {
   os << "${L:" << idx.Key() << "}";
   return os;
@@ -108,34 +155,6 @@ std::string Expr::Serialize() const {
   return ss.str();
 }
 
-auto Expr::IsEq(FlowPtr<Expr> o) const -> bool {
-  if (this == o.get()) {
-    return true;
-  }
-
-  if (GetKind() != o->GetKind()) {
-    return false;
-  }
-
-  std::stringstream ss1;
-  std::stringstream ss2;
-  AstWriter writer1(ss1);
-  AstWriter writer2(ss2);
-
-  const_cast<Expr *>(this)->Accept(writer1);
-  o.Accept(writer2);
-
-  return ss1.str() == ss2.str();
-}
-
-auto Expr::Hash64() const -> uint64_t {
-  std::stringstream ss;
-  AstWriter writer(ss);
-  const_cast<Expr *>(this)->Accept(writer);
-
-  return std::hash<std::string>{}(ss.str());
-}
-
 auto Expr::RecursiveChildCount() -> size_t {
   size_t count = 0;
 
@@ -144,8 +163,4 @@ auto Expr::RecursiveChildCount() -> size_t {
   return count;
 }
 
-void Expr::SetComments(std::span<const string> comments) {
-  auto old = ExtensionDataStore.Get(m_data);
-  old.AddComments(comments);
-  ExtensionDataStore.Set(m_data, std::move(old));
-}
+void Expr::SetComments(std::span<const string> comments) { ExtensionDataStore.AddComments(m_data, comments); }
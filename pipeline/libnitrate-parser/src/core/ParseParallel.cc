@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <core/SyntaxDiagnostics.hh>
+#include <core/TokenReplay.hh>
+#include <nitrate-core/Allocate.hh>
+#include <nitrate-core/Logger.hh>
+#include <nitrate-core/String.hh>
+#include <nitrate-lexer/Scanner.hh>
+#include <nitrate-parser/ASTFactory.hh>
+#include <nitrate-parser/ASTStmt.hh>
+#include <nitrate-parser/Algorithm.hh>
+#include <nitrate-parser/Context.hh>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace ncc;
+using namespace ncc::parse;
+using namespace ncc::lex;
+using namespace ncc::parse::ec;
+
+void ParserSetCurrentScanner(IScanner *scanner);
+
+/* Pieces smaller than this are not worth a parser of their own */
+static constexpr size_t kMinBatchTokens = 4096;
+static constexpr size_t kBatchesPerJob = 4;
+
+namespace {
+  struct CapturedMessage {
+    std::string m_message;
+    Sev m_sev;
+    const ECBase *m_by;
+  };
+
+  struct Batch {
+    std::span<const Token> m_tokens;
+    NullableFlowPtr<Expr> m_block;
+    std::vector<CapturedMessage> m_messages;
+    bool m_success = false;
+  };
+}  // namespace
+
+static auto Skim(IScanner &lexer) -> std::vector<Token> {
+  std::vector<Token> tokens;
+
+  /* Comments are kept so that every piece can bind its own */
+  const auto old_state = lexer.SkipCommentsState(false);
+  for (auto tok = lexer.Next(); tok.GetKind() != EofF; tok = lexer.Next()) {
+    tokens.push_back(tok);
+  }
+  lexer.SkipCommentsState(old_state);
+
+  return tokens;
+}
+
+static auto StartsDeclaration(const Token &tok) -> bool {
+  if (tok.GetKind() != KeyW) {
+    return false;
+  }
+
+  switch (tok.GetKeyword()) {
+    case Keyword::Scope:
+    case Keyword::Pub:
+    case Keyword::Sec:
+    case Keyword::Pro:
+    case Keyword::Import:
+    case Keyword::Type:
+    case Keyword::Let:
+    case Keyword::Var:
+    case Keyword::Const:
+    case Keyword::Static:
+    case Keyword::Struct:
+    case Keyword::Region:
+    case Keyword::Group:
+    case Keyword::Class:
+    case Keyword::Union:
+    case Keyword::Opaque:
+    case Keyword::Enum:
+    case Keyword::Fn:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/**
+ * Cuts after a ';' or '}' at bracket depth zero, if the next token begins a
+ * declaration. That keeps constructs such as `if {} else {}` in one piece.
+ */
+static auto Split(std::span<const Token> tokens, size_t target) -> std::vector<std::span<const Token>> {
+  std::vector<std::span<const Token>> pieces;
+  size_t depth = 0;
+  size_t begin = 0;
+
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    if (tokens[i].GetKind() != Punc) {
+      continue;
+    }
+
+    switch (tokens[i].GetPunctor()) {
+      case PuncLPar:
+      case PuncLBrk:
+      case PuncLCur: {
+        ++depth;
+        continue;
+      }
+
+      case PuncRPar:
+      case PuncRBrk: {
+        depth -= depth > 0 ? 1 : 0;
+        continue;
+      }
+
+      case PuncRCur: {
+        depth -= depth > 0 ? 1 : 0;
+        break;
+      }
+
+      case PuncSemi: {
+        break;
+      }
+
+      default: {
+        continue;
+      }
+    }
+
+    if (depth != 0 || i + 1 - begin < target) {
+      continue;
+    }
+
+    auto next = i + 1;
+    while (next < tokens.size() && tokens[next].GetKind() == Note) {
+      ++next;
+    }
+
+    if (next < tokens.size() && !StartsDeclaration(tokens[next])) {
+      continue;
+    }
+
+    pieces.push_back(tokens.subspan(begin, i + 1 - begin));
+    begin = i + 1;
+  }
+
+  if (begin < tokens.size() || pieces.empty()) {
+    pieces.push_back(tokens.subspan(begin));
+  }
+
+  return pieces;
+}
+
+static void ParseBatch(Batch &batch, IScanner &origin, const std::shared_ptr<IEnvironment> &env, DynamicArena &pool) {
+  /* Worker threads have their own logger; messages are replayed in order
+   * by the calling thread, which knows the origin scanner. */
+  auto sub_id = Log.Subscribe([&](const LogMessage &m) {
+    batch.m_messages.push_back({m.m_message, m.m_sev, &m.m_by});
+  });
+
+  TokenReplay replay(batch.m_tokens, origin);
+  auto root = GeneralParser(replay, env, pool).Parse();
+
+  batch.m_block = root.Get();
+  batch.m_success = root.Check();
+
+  Log.Unsubscribe(sub_id);
+}
+
+auto GeneralParser::ParseParallel(IScanner &lexer, std::shared_ptr<IEnvironment> env, DynamicArena &pool,
+                                  size_t jobs) -> ASTRoot {
+  if (jobs == 0) {
+    jobs = std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  const auto tokens = Skim(lexer);
+  const auto target = std::max(kMinBatchTokens, tokens.size() / (jobs * kBatchesPerJob));
+
+  std::vector<Batch> batches;
+  for (auto piece : Split(tokens, target)) {
+    batches.push_back({.m_tokens = piece});
+  }
+
+  { /* Parse the pieces on the worker pool */
+    std::atomic<size_t> next = 0;
+    auto *strings = StringPool::Current();
+
+    auto worker = [&]() {
+      std::optional<StringScope> string_scope;
+      if (strings != nullptr) {
+        string_scope.emplace(*strings);
+      }
+
+      for (size_t i = next++; i < batches.size(); i = next++) {
+        ParseBatch(batches[i], lexer, env, pool);
+      }
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(std::min(jobs, batches.size()));
+    for (size_t i = 0; i < std::min(jobs, batches.size()); ++i) {
+      workers.emplace_back(worker);
+    }
+  }
+
+  std::optional<ASTRoot> ast;
+
+  { /* Join the pieces on the calling thread */
+    ParserSetCurrentScanner(&lexer);
+    ASTExtensionScope extension_scope(pool);
+
+    bool failed = false;
+    auto sub_id = Log.Subscribe([&](const LogMessage &m) {
+      if (m.m_by.GetKind() == SyntaxError.GetKind()) {
+        failed = true;
+      }
+    });
+
+    std::vector<FlowPtr<Expr>> statements;
+    for (const auto &batch : batches) {
+      for (const auto &message : batch.m_messages) {
+        Log.Publish(message.m_message, message.m_sev, *message.m_by);
+      }
+
+      failed |= !batch.m_success;
+
+      auto block = batch.m_block.value();
+      if (block->Is(QAST_BLOCK)) {
+        auto items = block->As<Block>()->GetStatements();
+        statements.insert(statements.end(), items.begin(), items.end());
+      } else {
+        statements.push_back(block);
+      }
+    }
+
+    if (lexer.HasError()) {
+      Log << SyntaxError << "Some lexical errors have occurred";
+    }
+
+    auto root = ASTFactory(pool).CreateBlock(statements, BlockMode::Unknown);
+    root->SetOffset(batches.front().m_block.value()->Begin());
+
+    Log.Unsubscribe(sub_id);
+    ParserSetCurrentScanner(nullptr);
+
+    ast = ASTRoot(FlowPtr<Expr>(root), !failed);
+  }
+
+  return ast.value();
+}
@@ -473,6 +473,9 @@ auto GeneralParser::Parse() -> ASTRoot {
   { /* Assign the current context to thread-local global state */
     ParserSetCurrentScanner(&m_impl->m_rd);
 
+    /* Locations and comments live as long as the nodes they belong to */
+    ASTExtensionScope extension_scope(m_impl->m_pool);
+
     { /* Subscribe to events emitted by the parser */
       auto sub_id = Log.Subscribe([this](const LogMessage &m) {
         if (m.m_by.GetKind() == SyntaxError.GetKind()) {
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __NITRATE_AST_TOKEN_REPLAY_H__
+#define __NITRATE_AST_TOKEN_REPLAY_H__
+
+#include <nitrate-lexer/Scanner.hh>
+#include <span>
+
+namespace ncc::parse {
+  /** Replays a slice of a token stream that another scanner produced. */
+  class TokenReplay final : public lex::IScanner {
+    std::span<const lex::Token> m_tokens;
+    size_t m_pos = 0;
+    IScanner &m_origin;
+
+  protected:
+    auto GetNext() -> lex::Token override {
+      return m_pos < m_tokens.size() ? m_tokens[m_pos++] : lex::Token::EndOfFile();
+    }
+
+    /* The tokens were already scanned, so resolving their locations is read-only */
+    auto GetLocationFallback(lex::LocationID id) -> std::optional<lex::Location> override {
+      return m_origin.GetLocation(id);
+    }
+
+  public:
+    TokenReplay(std::span<const lex::Token> tokens, IScanner &origin)
+        : IScanner(origin.GetEnvironment()), m_tokens(tokens), m_origin(origin) {}
+
+    auto GetSourceWindow(Point start, Point end, char fillchar) -> std::optional<std::vector<std::string>> override {
+      return m_origin.GetSourceWindow(start, end, fillchar);
+    }
+  };
+}  // namespace ncc::parse
+
+#endif
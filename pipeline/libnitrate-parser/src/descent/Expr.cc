@@ -46,7 +46,7 @@ using namespace ncc::lex;
 using namespace ncc::parse;
 using namespace ncc;
 
-auto GeneralParser::PImpl::RecurseCallArguments(const std::set<lex::Token> &terminators,
+auto GeneralParser::PImpl::RecurseCallArguments(TerminatorSet terminators,
                                                 bool type_by_default) -> std::vector<CallArg> {
   std::vector<CallArg> call_args;
   size_t positional_index = 0;
@@ -58,7 +58,7 @@ auto GeneralParser::PImpl::RecurseCallArguments(const std::set<lex::Token> &term
       return call_args;
     }
 
-    if (terminators.contains(Peek())) {
+    if (terminators.Contains(Peek())) {
       break;
     }
 
@@ -79,9 +79,7 @@ auto GeneralParser::PImpl::RecurseCallArguments(const std::set<lex::Token> &term
       auto argument_value = RecurseType();
       call_args.emplace_back(argument_name, argument_value);
     } else {
-      std::set<Token> terminators_copy(terminators);
-      terminators_copy.insert(Token(Punc, PuncComa));
-      auto argument_value = RecurseExpr(terminators_copy);
+      auto argument_value = RecurseExpr(terminators.With(Token(Punc, PuncComa)));
       call_args.emplace_back(argument_name, argument_value);
     }
 
@@ -228,7 +226,7 @@ static NCC_FORCE_INLINE auto UnwindStack(ASTFactory &fac, std::stack<Frame> &sta
   return base;
 }
 
-auto GeneralParser::PImpl::RecurseExpr(const std::set<Token> &terminators) -> FlowPtr<Expr> {
+auto GeneralParser::PImpl::RecurseExpr(TerminatorSet terminators) -> FlowPtr<Expr> {
   auto source_offset = Peek().GetStart();
 
   std::stack<Frame> stack;
@@ -261,7 +259,7 @@ auto GeneralParser::PImpl::RecurseExpr(const std::set<Token> &terminators) -> Fl
     while (!stack.empty() && spinning) {
       auto tok = Peek();
 
-      if (terminators.contains(tok)) {
+      if (terminators.Contains(tok)) {
         break;
       }
 
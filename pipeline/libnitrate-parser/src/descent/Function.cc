@@ -357,7 +357,8 @@ auto GeneralParser::PImpl::RecurseFunction(bool parse_declaration_only) -> FlowP
   auto function_template_parameters = RecurseTemplateParameters();
   auto function_parameters = RecurseFunctionParameters();
   auto function_return_type = RecurseFunctionReturnType();
-  auto function_body = RecurseFunctionBody(parse_declaration_only);
+  auto deferred_body = parse_declaration_only ? std::nullopt : DeferFunctionBody();
+  auto function_body = deferred_body ? nullptr : RecurseFunctionBody(parse_declaration_only);
 
   auto function = m_fac.CreateFunction(function_name, function_return_type, function_parameters.first,
                                        function_parameters.second, function_body, function_purity, function_attributes,
@@ -368,5 +369,9 @@ auto GeneralParser::PImpl::RecurseFunction(bool parse_declaration_only) -> FlowP
 
   function.value()->SetOffset(start_pos);
 
+  if (deferred_body) {
+    m_deferred.emplace(function.value().get(), std::move(deferred_body.value()));
+  }
+
   return function.value();
 }
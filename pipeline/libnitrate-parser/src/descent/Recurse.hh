@@ -36,8 +36,11 @@
 
 #include <boost/shared_ptr.hpp>
 #include <core/SyntaxDiagnostics.hh>
+#include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <memory_resource>
+#include <nitrate-core/Assert.hh>
 #include <nitrate-core/IEnvironment.hh>
 #include <nitrate-core/Logger.hh>
 #include <nitrate-lexer/Scanner.hh>
@@ -47,11 +50,67 @@
 #include <nitrate-parser/ASTStmt.hh>
 #include <nitrate-parser/ASTType.hh>
 #include <nitrate-parser/Context.hh>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace ncc::parse {
   using namespace ec;
 
+  /**
+   * Punctuators and operators that end an expression. The set is two words
+   * wide, so building and extending it on the hot parsing path never touches
+   * the heap.
+   */
+  class TerminatorSet final {
+    static_assert(lex::PuncScope < 64 && lex::Op_Last < 64);
+
+    uint64_t m_punc = 0;
+    uint64_t m_oper = 0;
+
+  public:
+    constexpr TerminatorSet() = default;
+    constexpr TerminatorSet(std::initializer_list<lex::Token> tokens) {
+      for (const auto &tok : tokens) {
+        Insert(tok);
+      }
+    }
+
+    constexpr void Insert(lex::Token tok) {
+      switch (tok.GetKind()) {
+        case lex::Punc: {
+          m_punc |= uint64_t(1) << tok.GetPunctor();
+          break;
+        }
+
+        case lex::Oper: {
+          m_oper |= uint64_t(1) << tok.GetOperator();
+          break;
+        }
+
+        default: {
+          qcore_panic("Only punctuators and operators can terminate an expression");
+        }
+      }
+    }
+
+    [[nodiscard]] constexpr auto With(lex::Token tok) const -> TerminatorSet {
+      auto copy = *this;
+      copy.Insert(tok);
+      return copy;
+    }
+
+    [[nodiscard]] constexpr auto Contains(lex::Token tok) const -> bool {
+      switch (tok.GetKind()) {
+        case lex::Punc:
+          return ((m_punc >> tok.GetPunctor()) & 1) != 0;
+        case lex::Oper:
+          return ((m_oper >> tok.GetOperator()) & 1) != 0;
+        default:
+          return false;
+      }
+    }
+  };
+
   class GeneralParser::PImpl final {
     friend class GeneralParser;
 
@@ -61,8 +120,13 @@ namespace ncc::parse {
     lex::IScanner &m_rd;
     bool m_failed = false;
 
+    /* Tokens of function bodies and variable initializers that were skipped */
+    bool m_lazy_bodies = false;
+    std::unordered_map<const Expr *, std::vector<lex::Token>> m_deferred;
+
     lex::Token Next() { return m_rd.Next(); }
     lex::Token Peek() { return m_rd.Peek(); }
+    lex::Token Peek(size_t n) { return m_rd.Peek(n); }
     lex::Token Current() { return m_rd.Current(); }
 
     template <auto tok>
@@ -130,7 +194,7 @@ namespace ncc::parse {
     auto RecurseThrow() -> FlowPtr<Expr>;
     auto RecurseAwait() -> FlowPtr<Expr>;
     auto RecurseBlock(bool expect_braces, bool single_stmt, BlockMode safety) -> FlowPtr<Expr>;
-    auto RecurseExpr(const std::set<lex::Token> &terminators) -> FlowPtr<Expr>;
+    auto RecurseExpr(TerminatorSet terminators) -> FlowPtr<Expr>;
     auto RecurseExprPrimary(bool is_type) -> NullableFlowPtr<Expr>;
     auto RecurseExprKeyword(lex::Keyword key) -> NullableFlowPtr<Expr>;
     auto RecurseExprPunctor(lex::Punctor punc) -> NullableFlowPtr<Expr>;
@@ -151,7 +215,7 @@ namespace ncc::parse {
     auto RecurseExportAttributes() -> std::optional<std::vector<FlowPtr<Expr>>>;
     auto RecurseExportBody() -> FlowPtr<Expr>;
 
-    auto RecurseCallArguments(const std::set<lex::Token> &terminators, bool type_by_default) -> std::vector<CallArg>;
+    auto RecurseCallArguments(TerminatorSet terminators, bool type_by_default) -> std::vector<CallArg>;
     auto RecurseFstring() -> FlowPtr<Expr>;
 
     auto RecurseForInitExpr() -> NullableFlowPtr<Expr>;
@@ -217,6 +281,14 @@ namespace ncc::parse {
 
     auto RecurseWhileCond() -> FlowPtr<Expr>;
 
+    /****************************************************************************
+     * @brief
+     *  Deferred parsing
+     ****************************************************************************/
+
+    auto DeferFunctionBody() -> std::optional<std::vector<lex::Token>>;
+    auto DeferVariableValue() -> std::optional<std::vector<lex::Token>>;
+
   public:
     PImpl(lex::IScanner &lexer, std::shared_ptr<IEnvironment> env, std::pmr::memory_resource &pool)
         : m_env(std::move(env)), m_pool(pool), m_fac(m_pool), m_rd(lexer) {}
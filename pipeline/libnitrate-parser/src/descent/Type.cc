@@ -95,7 +95,7 @@ auto GeneralParser::PImpl::RecurseTypeTemplateArguments() -> std::optional<std::
 }
 
 auto GeneralParser::PImpl::RecurseTypeSuffix(FlowPtr<Type> base) -> FlowPtr<parse::Type> {
-  static auto bit_width_terminaters = {
+  static constexpr TerminatorSet kBitWidthTerminators = {
       Token(Punc, PuncRPar), Token(Punc, PuncRBrk), Token(Punc, PuncLCur), Token(Punc, PuncRCur), Token(Punc, PuncComa),
       Token(Punc, PuncColn), Token(Punc, PuncSemi), Token(Oper, OpSet),    Token(Oper, OpMinus),  Token(Oper, OpGT)};
 
@@ -115,10 +115,10 @@ auto GeneralParser::PImpl::RecurseTypeSuffix(FlowPtr<Type> base) -> FlowPtr<pars
       range.second = RecurseTypeRangeEnd();
 
       if (NextIf<PuncColn>()) {
-        width = RecurseExpr(bit_width_terminaters);
+        width = RecurseExpr(kBitWidthTerminators);
       }
     } else {
-      width = RecurseExpr(bit_width_terminaters);
+      width = RecurseExpr(kBitWidthTerminators);
     }
   }
 
@@ -88,9 +88,16 @@ auto GeneralParser::PImpl::RecurseVariableInstance(VariableType decl_type) -> Nu
   auto symbol_attributes_opt = RecurseVariableAttributes();
   if (auto variable_name = RecurseName()) {
     auto variable_type = RecurseVariableType();
-    auto variable_initial = RecurseVariableValue();
+    auto deferred_value = DeferVariableValue();
+    auto variable_initial = deferred_value ? nullptr : RecurseVariableValue();
 
-    return m_fac.CreateVariable(decl_type, variable_name, symbol_attributes_opt, variable_type, variable_initial);
+    auto variable =
+        m_fac.CreateVariable(decl_type, variable_name, symbol_attributes_opt, variable_type, variable_initial);
+    if (deferred_value) {
+      m_deferred.emplace(variable.get(), std::move(deferred_value.value()));
+    }
+
+    return variable;
   }
 
   Log << SyntaxError << Current() << "Expected variable name";
@@ -42,6 +42,7 @@
 #include <nitrate-lexer/Lexer.hh>
 #include <optional>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 struct lua_State;
@@ -50,8 +51,17 @@ namespace ncc::seq {
   using FetchModuleFunc = std::function<std::optional<std::string>(std::string_view)>;
   auto FileSystemFetchModule(std::string_view path) -> std::optional<std::string>;
 
+  /**
+   * Keep the resolved NCC_SEARCH_PATH index across jobs and invalidate it
+   * through inotify instead of rebuilding it for every job. Meant for
+   * long-running hosts such as the language server.
+   */
+  auto WatchResourceSearchPaths(bool enable) -> void;
+
   class Sequencer;
+  class SequencerPool;
   class SequencerPImpl;
+  class Expansion;
   using MethodType = int (seq::Sequencer::*)();
 
   extern const std::string_view SEQUENCER_DIALECT_CODE_PREFIX;
@@ -59,6 +69,7 @@ namespace ncc::seq {
   class NCC_EXPORT Sequencer final : public lex::IScanner {
     lex::Tokenizer m_scanner;
     std::shared_ptr<SequencerPImpl> m_shared;
+    std::vector<std::unique_ptr<Expansion>> m_frames;
 
     ///=========================================================================
     /// Preprocessor API route handlers
@@ -66,6 +77,7 @@ namespace ncc::seq {
     [[nodiscard]] int32_t SysNext();
     [[nodiscard]] int32_t SysPeek();
     [[nodiscard]] int32_t SysEmit();
+    [[nodiscard]] int32_t SysEmitTok();
     [[nodiscard]] int32_t SysDebug();
     [[nodiscard]] int32_t SysInfo();
     [[nodiscard]] int32_t SysWarn();
@@ -81,6 +93,7 @@ namespace ncc::seq {
     ///=========================================================================
     /// Helper functions to configure the LUA interpreter
 
+    static void Initialize(Sequencer& self);
     static void BindMethod(Sequencer& self, const char* name, MethodType func) noexcept;
     static void AttachAPIFunctions(Sequencer& self) noexcept;
     static void LoadSecureLibs(Sequencer& self) noexcept;
@@ -89,9 +102,17 @@ namespace ncc::seq {
     /// Preprocessor helper functions
 
     static auto FetchModuleData(Sequencer& self, std::string_view module_name) -> std::optional<std::string>;
-    static auto ExecuteLua(Sequencer& self, const char* code) -> std::optional<std::string>;
+    static auto LoadCachedChunk(Sequencer& self, const std::string& code) -> bool;
+    static auto CallLuaFunction(Sequencer& self, bool keep_results) -> std::optional<std::string>;
+    static auto ExecuteLua(Sequencer& self, const std::string& code) -> std::optional<std::string>;
+    static auto ExecuteBytecode(Sequencer& self, std::string_view bytecode) -> std::optional<std::string>;
     static auto CreateChild(Sequencer& self, std::istream& file) -> std::unique_ptr<Sequencer>;
-    static auto SequenceSource(Sequencer& self, std::string_view code) -> void;
+    static auto PushExpansion(Sequencer& self, std::unique_ptr<Expansion> expansion) -> bool;
+    static auto SequenceSource(Sequencer& self, std::string code) -> void;
+    static auto BeginExpansion(Sequencer& self, std::string macro) -> void;
+    static auto EndExpansion(Sequencer& self, std::optional<std::string> result) -> bool;
+    static auto SequencePrecompiled(Sequencer& self, std::string_view code,
+                                    const std::optional<std::vector<std::string>>& bytecode) -> void;
     static auto HandleImportDirective(Sequencer& self) -> bool;
     static auto HandleMacroBlock(Sequencer& self, lex::Token macro) -> bool;
     static auto HandleMacroStatement(Sequencer& self, lex::Token macro) -> bool;
@@ -100,11 +121,14 @@ namespace ncc::seq {
     ///=========================================================================
     /// IScanner overrides
 
+    auto NextRaw() -> lex::Token;
     auto GetNext() -> lex::Token override;
     auto GetLocationFallback(lex::LocationID id) -> std::optional<lex::Location> override;
 
     Sequencer(std::istream& file, std::shared_ptr<SequencerPImpl> shared);
 
+    friend class SequencerPool;
+
   public:
     Sequencer(std::istream& file, std::shared_ptr<IEnvironment> env);
     ~Sequencer() override;
@@ -113,9 +137,44 @@ namespace ncc::seq {
     auto SetFailBit(bool fail = true) -> bool override;
 
     auto SetFetchFunc(FetchModuleFunc func) -> void;
+
+    /**
+     * @brief Get the macro profile of this job as JSON.
+     *
+     * @details Every macro reports its call count, cumulative wall time,
+     * Lua instructions and the number of tokens it produced. Instructions are
+     * counted in steps of the VM hook interval, so they are deterministic
+     * but approximate. The instruction budget is read from the environment
+     * key "seq.instruction-budget"; zero or unset means unlimited.
+     */
+    [[nodiscard]] auto GetProfile() const -> std::string;
+
     auto GetSourceWindow(Point start, Point end, char fillchar) -> std::optional<std::vector<std::string>> override;
   };
 
+  /**
+   * @brief Hands out sequencers backed by already initialized Lua states.
+   *
+   * @details A state is returned to the pool once its sequencer (and every
+   * child of it) is destroyed. Every table reachable from its globals or
+   * from the string metatable, and the metatables of those tables, are then
+   * restored to what they were right after the prelude ran, so jobs cannot
+   * observe each other. Upvalues of the prelude's functions are not
+   * restored; the prelude keeps no state in them.
+   * The pool may be shared between threads; each sequencer must not.
+   */
+  class NCC_EXPORT SequencerPool final {
+    class Impl;
+    std::shared_ptr<Impl> m_impl;
+
+  public:
+    explicit SequencerPool(size_t max_idle = std::thread::hardware_concurrency());
+    SequencerPool(const SequencerPool&) = delete;
+    ~SequencerPool();
+
+    [[nodiscard]] auto Create(std::istream& file, std::shared_ptr<IEnvironment> env) -> std::unique_ptr<Sequencer>;
+    [[nodiscard]] auto GetIdleCount() const -> size_t;
+  };
 }  // namespace ncc::seq
 
 #endif
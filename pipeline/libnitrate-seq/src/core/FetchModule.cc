@@ -31,22 +31,41 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <array>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/uuid/detail/sha1.hpp>
+#include <charconv>
 #include <core/EC.hh>
 #include <core/PImpl.hh>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <nitrate-core/Cache.hh>
 #include <nitrate-core/IEnvironment.hh>
 #include <nitrate-parser/ASTStmt.hh>
 #include <nitrate-parser/Algorithm.hh>
 #include <nitrate-parser/CodeWriter.hh>
 #include <nitrate-parser/Context.hh>
 #include <nitrate-seq/Sequencer.hh>
+#include <optional>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+extern "C" {
+#include <lua/lua.h>
+}
 
 using namespace ncc;
 using namespace ncc::seq;
@@ -63,44 +82,191 @@ static std::string ReadEnvironmentVariable(const char *name) {
   return value;
 }
 
-static std::vector<path> GetResourceSearchPaths() {
-  std::string env_path(ReadEnvironmentVariable("NCC_SEARCH_PATH"));
-
+static auto ParseResourceSearchPaths(const std::string &env_path) -> std::vector<path> {
   std::vector<path> paths;
-  std::string the_path;
+  std::error_code ec;
+
   size_t start = 0;
-  size_t end = env_path.find(':');
-  while (end != std::string::npos) {
-    the_path = env_path.substr(start, end - start);
-    paths.emplace_back(exists(the_path) ? absolute(the_path) : path(the_path));
-    start = end + 1;
-    end = env_path.find(':', start);
-  }
+  while (start <= env_path.size()) {
+    auto end = env_path.find(':', start);
+    if (end == std::string::npos) {
+      end = env_path.size();
+    }
 
-  the_path = env_path.substr(start, end);
-  paths.emplace_back(exists(the_path) ? absolute(the_path) : path(the_path));
+    /* An empty entry (e.g. an unset variable) means the working directory.
+     * Entries that do not exist yet are kept, so they are found once created. */
+    auto the_path = start == end ? current_path(ec) : path(env_path.substr(start, end - start));
+    paths.emplace_back(absolute(the_path, ec));
 
-  (void)std::remove_if(paths.begin(), paths.end(),
-                       [](const auto &path) { return !exists(path) || !is_directory(path); });
+    start = end + 1;
+  }
 
   return paths;
 }
 
-static std::optional<path> FindResource(const std::string &resource_name, const std::vector<path> &search_paths) {
-  for (const auto &path : search_paths) {
-    Log << SeqLog << Debug << "Searching for resource '" << resource_name << "' in " << path;
+namespace {
+  /**
+   * Resolved NCC_SEARCH_PATH together with cached directory listings and
+   * lookup results, including misses. Without watch mode an index belongs to
+   * a single job. In watch mode one index serves every job until inotify
+   * reports a change in one of the listed directories, or in the nearest
+   * existing ancestor of a listed directory that does not exist.
+   */
+  class ResourceIndex {
+    std::string m_env_path;
+    std::vector<path> m_search_paths;
+    std::unordered_map<std::string, std::unordered_set<std::string>> m_listings;
+    std::unordered_map<std::string, std::optional<path>> m_results;
+    int m_inotify = -1;
+    bool m_watch;
+    /* A listed directory could not be watched, so nothing cached is trusted */
+    bool m_unwatched = false;
+
+    auto Listing(const path &dir) -> const std::unordered_set<std::string> & {
+      auto [it, inserted] = m_listings.try_emplace(dir.native());
+      if (!inserted) [[likely]] {
+        return it->second;
+      }
+
+      std::error_code ec;
+      for (auto entry = directory_iterator(dir, ec); !ec && entry != directory_iterator(); entry.increment(ec)) {
+        if (entry->is_regular_file(ec)) {
+          it->second.insert(entry->path().filename().native());
+        }
+      }
+
+#ifdef __linux__
+      if (m_inotify != -1) {
+        /* A missing directory cannot be watched. Its nearest existing ancestor
+         * reports when the next component along the path gets created. */
+        auto watched = dir;
+        while (!is_directory(watched, ec) && watched.has_relative_path()) {
+          watched = watched.parent_path();
+        }
+
+        const auto mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+        if (inotify_add_watch(m_inotify, watched.c_str(), mask) == -1) [[unlikely]] {
+          m_unwatched = true;
+        }
+      }
+#endif
+
+      return it->second;
+    }
 
-    auto alleged_path = path / resource_name;
-    if (exists(alleged_path) && is_regular_file(alleged_path)) {
-      Log << SeqLog << Debug << "Found resource '" << resource_name << "' at " << alleged_path;
-      return alleged_path;
+  public:
+    ResourceIndex(std::string env_path, bool watch)
+        : m_env_path(std::move(env_path)), m_search_paths(ParseResourceSearchPaths(m_env_path)), m_watch(watch) {
+#ifdef __linux__
+      if (m_watch) {
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        m_unwatched = m_inotify == -1;
+      }
+#endif
     }
 
-    Log << SeqLog << Debug << "Resource '" << resource_name << "' not found at " << alleged_path;
-  }
+    ResourceIndex(const ResourceIndex &) = delete;
+    ResourceIndex(ResourceIndex &&) = delete;
 
-  return std::nullopt;
-}
+    ~ResourceIndex() {
+#ifdef __linux__
+      if (m_inotify != -1) {
+        close(m_inotify);
+      }
+#endif
+    }
+
+    [[nodiscard]] auto GetEnvPath() const -> const std::string & { return m_env_path; }
+
+    auto IsStale() -> bool {
+      if (!m_watch) {
+        return false;
+      }
+
+#ifdef __linux__
+      std::array<char, 4096> events;
+      bool any = m_unwatched;
+      while (m_inotify != -1 && read(m_inotify, events.data(), events.size()) > 0) {
+        any = true;
+      }
+
+      return any;
+#else
+      return true;
+#endif
+    }
+
+    auto Find(const std::string &resource_name) -> std::optional<path> {
+      if (auto it = m_results.find(resource_name); it != m_results.end()) {
+        return it->second;
+      }
+
+      std::optional<path> result;
+      for (const auto &search_path : m_search_paths) {
+        auto alleged_path = (search_path / resource_name).lexically_normal();
+        if (Listing(alleged_path.parent_path()).contains(alleged_path.filename().native())) {
+          Log << SeqLog << Debug << "Found resource '" << resource_name << "' at " << alleged_path;
+          result = std::move(alleged_path);
+          break;
+        }
+      }
+
+      if (!result) {
+        Log << SeqLog << Debug << "Resource '" << resource_name << "' not found in any search path";
+      }
+
+      return m_results.emplace(resource_name, std::move(result)).first->second;
+    }
+  };
+
+  /* Indexes of the most recently active jobs, most recent first. Jobs that
+   * are preprocessed concurrently keep their own index instead of evicting
+   * each other's. */
+  class ResourceIndexes {
+    static constexpr size_t kMaxIndexes = 16;
+
+    std::mutex m_mutex;
+    std::list<std::pair<std::string, std::unique_ptr<ResourceIndex>>> m_indexes;
+    bool m_watch = false;
+
+  public:
+    void SetWatchMode(bool enable) {
+      std::lock_guard lock(m_mutex);
+
+      m_watch = enable;
+      m_indexes.clear();
+    }
+
+    auto Find(std::string_view job, const std::string &resource_name) -> std::optional<path> {
+      std::lock_guard lock(m_mutex);
+
+      /* In watch mode a single index serves every job */
+      const auto key = m_watch ? std::string() : std::string(job);
+      auto env_path = ReadEnvironmentVariable("NCC_SEARCH_PATH");
+
+      auto it = std::find_if(m_indexes.begin(), m_indexes.end(), [&](const auto &entry) { return entry.first == key; });
+      if (it != m_indexes.end() && (it->second->GetEnvPath() != env_path || it->second->IsStale())) {
+        m_indexes.erase(it);
+        it = m_indexes.end();
+      }
+
+      if (it == m_indexes.end()) {
+        m_indexes.emplace_front(key, std::make_unique<ResourceIndex>(std::move(env_path), m_watch));
+        if (m_indexes.size() > kMaxIndexes) {
+          m_indexes.pop_back();
+        }
+      } else {
+        m_indexes.splice(m_indexes.begin(), m_indexes, it);
+      }
+
+      return m_indexes.front().second->Find(resource_name);
+    }
+  };
+
+  ResourceIndexes TheResourceIndexes;
+}  // namespace
+
+NCC_EXPORT auto ncc::seq::WatchResourceSearchPaths(bool enable) -> void { TheResourceIndexes.SetWatchMode(enable); }
 
 NCC_EXPORT auto ncc::seq::FileSystemFetchModule(std::string_view path) -> std::optional<std::string> {
   const auto expected_prefix = "file:///package/"sv;
@@ -113,11 +279,10 @@ NCC_EXPORT auto ncc::seq::FileSystemFetchModule(std::string_view path) -> std::o
     return std::nullopt;
   }
 
-  // const auto job_uuid = path.substr(0, 36);
+  const auto job_uuid = path.substr(0, 36);
   path.remove_prefix(37);
 
-  const auto resource_search_paths = GetResourceSearchPaths();
-  if (const auto the_path = FindResource(std::string(path), resource_search_paths)) {
+  if (const auto the_path = TheResourceIndexes.Find(job_uuid, std::string(path))) {
     if (auto file = std::fstream(the_path->string(), std::ios::in); file.is_open()) {
       return std::string((std::istreambuf_iterator<char>(file)), (std::istreambuf_iterator<char>()));
     }
@@ -128,6 +293,379 @@ NCC_EXPORT auto ncc::seq::FileSystemFetchModule(std::string_view path) -> std::o
   return std::nullopt;
 }
 
+static auto GetEnvironmentKeys(IEnvironment &env) -> std::vector<std::string> {
+  /* Same encoding that n.env_keys() decodes: "<length> <key>" repeated */
+  std::vector<std::string> keys;
+
+  const auto data = env.Get("this.keys");
+  if (!data) {
+    return keys;
+  }
+
+  std::string_view rest = *data.value();
+  while (!rest.empty()) {
+    size_t length = 0;
+    auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), length);
+    if (ec != std::errc() || ptr == rest.data() + rest.size()) [[unlikely]] {
+      break;
+    }
+
+    rest.remove_prefix(ptr - rest.data() + 1);
+    if (length > rest.size()) [[unlikely]] {
+      break;
+    }
+
+    keys.emplace_back(rest.substr(0, length));
+    rest.remove_prefix(length);
+  }
+
+  return keys;
+}
+
+namespace {
+  /* SHA-1 over length-prefixed fields, so field boundaries are unambiguous */
+  class FieldHasher {
+    boost::uuids::detail::sha1 m_sha1;
+
+  public:
+    void Feed(std::string_view data) {
+      const auto length = std::to_string(data.size()) + ":";
+      m_sha1.process_bytes(length.data(), length.size());
+      m_sha1.process_bytes(data.data(), data.size());
+    }
+
+    auto Digest() -> ResourceKey {
+      boost::uuids::detail::sha1::digest_type digest;
+      m_sha1.get_digest(digest);
+
+      static_assert(sizeof(digest) == kResourceKeySize);
+
+      /* Older Boost releases return five 32-bit words instead of raw bytes */
+      ResourceKey result;
+      constexpr size_t kWordSize = sizeof(digest[0]);
+      for (size_t i = 0; i < std::size(digest); ++i) {
+        for (size_t j = 0; j < kWordSize; ++j) {
+          result[i * kWordSize + j] = static_cast<uint8_t>(digest[i] >> ((kWordSize - 1 - j) * 8));
+        }
+      }
+
+      return result;
+    }
+  };
+}  // namespace
+
+static auto DescribeLuaScalar(lua_State *lua, int key) -> std::string {
+  switch (lua_type(lua, key)) {
+    case LUA_TSTRING: {
+      size_t length = 0;
+      const auto *data = lua_tolstring(lua, key, &length);
+      return "s" + std::string(data, length);
+    }
+
+    case LUA_TNUMBER: {
+      /* lua_tolstring() would turn the number on the stack into a string */
+      if (lua_isinteger(lua, key) != 0) {
+        return "i" + std::to_string(lua_tointeger(lua, key));
+      }
+
+      std::array<char, 32> digits;
+      auto [end, _] = std::to_chars(digits.data(), digits.data() + digits.size(), lua_tonumber(lua, key));
+      return "f" + std::string(digits.data(), end);
+    }
+
+    case LUA_TBOOLEAN: {
+      return lua_toboolean(lua, key) != 0 ? "btrue" : "bfalse";
+    }
+
+    default: {
+      /* Keys of other types are rare and only ordered by type */
+      return std::string("x") + lua_typename(lua, lua_type(lua, key));
+    }
+  }
+}
+
+/* Tables nested deeper than this make the state unhashable, which only
+ * disables the import cache. It bounds the native stack used for hashing. */
+static constexpr size_t kMaxStateDepth = 200;
+
+static auto FeedLuaValue(lua_State *lua, int value, FieldHasher &hasher,
+                         std::unordered_map<const void *, size_t> &visited, size_t depth) -> bool {
+  /**
+   * Tables are walked in key order and functions are fed as bytecode, so the
+   * result does not depend on addresses or on the hash seed of the state.
+   * C functions are only distinguished by their position in the graph.
+   */
+
+  value = lua_absindex(lua, value);
+
+  const auto type = lua_type(lua, value);
+  switch (type) {
+    case LUA_TNIL:
+    case LUA_TBOOLEAN:
+    case LUA_TNUMBER:
+    case LUA_TSTRING: {
+      hasher.Feed(DescribeLuaScalar(lua, value));
+      return true;
+    }
+
+    case LUA_TTABLE:
+    case LUA_TFUNCTION: {
+      break;
+    }
+
+    default: {
+      hasher.Feed(lua_typename(lua, type));
+      return true;
+    }
+  }
+
+  if (auto [it, inserted] = visited.try_emplace(lua_topointer(lua, value), visited.size()); !inserted) {
+    hasher.Feed("ref " + std::to_string(it->second));
+    return true;
+  }
+
+  if (depth >= kMaxStateDepth || lua_checkstack(lua, 4) == 0) [[unlikely]] {
+    return false;
+  }
+
+  const auto top = lua_gettop(lua);
+
+  if (type == LUA_TFUNCTION) {
+    if (lua_iscfunction(lua, value) != 0) {
+      hasher.Feed("cfunction");
+      return true;
+    }
+
+    std::string bytecode;
+    lua_pushvalue(lua, value);
+    lua_dump(
+        lua,
+        [](lua_State *, const void *p, size_t sz, void *ud) {
+          static_cast<std::string *>(ud)->append(static_cast<const char *>(p), sz);
+          return 0;
+        },
+        &bytecode, 1);
+    lua_pop(lua, 1);
+
+    hasher.Feed("function");
+    hasher.Feed(bytecode);
+
+    for (int i = 1; lua_getupvalue(lua, value, i) != nullptr; ++i) {
+      if (!FeedLuaValue(lua, -1, hasher, visited, depth + 1)) [[unlikely]] {
+        lua_settop(lua, top);
+        return false;
+      }
+
+      lua_pop(lua, 1);
+    }
+
+    return true;
+  }
+
+  std::vector<std::pair<std::string, lua_Integer>> keys;
+  lua_newtable(lua);
+  lua_pushnil(lua);
+  while (lua_next(lua, value) != 0) {
+    lua_pop(lua, 1);
+    keys.emplace_back(DescribeLuaScalar(lua, -1), keys.size() + 1);
+    lua_pushvalue(lua, -1);
+    lua_rawseti(lua, -3, keys.back().second);
+  }
+
+  std::sort(keys.begin(), keys.end());
+
+  hasher.Feed("table " + std::to_string(keys.size()));
+  for (const auto &[_, index] : keys) {
+    lua_rawgeti(lua, -1, index);
+    if (!FeedLuaValue(lua, -1, hasher, visited, depth + 1)) [[unlikely]] {
+      lua_settop(lua, top);
+      return false;
+    }
+
+    lua_rawget(lua, value);
+    if (!FeedLuaValue(lua, -1, hasher, visited, depth + 1)) [[unlikely]] {
+      lua_settop(lua, top);
+      return false;
+    }
+
+    lua_pop(lua, 1);
+  }
+  lua_pop(lua, 1);
+
+  if (lua_getmetatable(lua, value) != 0) {
+    hasher.Feed("metatable");
+    const auto ok = FeedLuaValue(lua, -1, hasher, visited, depth + 1);
+    lua_pop(lua, 1);
+
+    return ok;
+  }
+
+  return true;
+}
+
+static auto GetStateDigest(SequencerPImpl &shared) -> std::optional<ResourceKey> {
+  /**
+   * Everything that macros of an imported module can read or change: the
+   * environment except the entries that are unique per job, the Lua state
+   * reachable from the globals and from the string metatable, and the state
+   * of `n.random`. Empty if the Lua state is nested too deeply to be hashed.
+   */
+
+  FieldHasher hasher;
+
+  auto keys = GetEnvironmentKeys(*shared.m_env);
+  std::sort(keys.begin(), keys.end());
+  for (const auto &key : keys) {
+    if (key == "this.job" || key == "this.created_at" || key == "this.keys") {
+      continue;
+    }
+
+    hasher.Feed(key);
+    hasher.Feed(*shared.m_env->Get(key).value_or(""));
+  }
+
+  auto *lua = shared.m_L;
+  const auto top = lua_gettop(lua);
+  std::unordered_map<const void *, size_t> visited;
+
+  lua_pushglobaltable(lua);
+  auto ok = FeedLuaValue(lua, -1, hasher, visited, 0);
+
+  lua_pushstring(lua, "");
+  if (ok && lua_getmetatable(lua, -1) != 0) {
+    ok = FeedLuaValue(lua, -1, hasher, visited, 0);
+  }
+  lua_settop(lua, top);
+
+  if (!ok) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  std::ostringstream random;
+  random << shared.m_random;
+  hasher.Feed(random.str());
+
+  return hasher.Digest();
+}
+
+static auto GetImportCacheKey(std::string_view module_content, const ResourceKey &state) -> ResourceKey {
+  /**
+   * Rendering a module runs its macros, so the key covers the module text and
+   * the state they run against. Resources fetched while rendering are stored
+   * in the entry and checked when it is read.
+   */
+
+  FieldHasher hasher;
+  hasher.Feed("nitrate-seq.import.v2");
+  hasher.Feed(module_content);
+  hasher.Feed(std::string_view(reinterpret_cast<const char *>(state.data()), state.size()));
+
+  return hasher.Digest();
+}
+
+static auto EncodeCachedImport(const ImportDependencies &dependencies, std::string_view rendered) -> std::string {
+  /* Length-prefixed fields: the dependency count, a name and digest per
+   * dependency, then the rendered interface */
+
+  std::string entry;
+  const auto put = [&](std::string_view field) {
+    entry += std::to_string(field.size());
+    entry += ':';
+    entry += field;
+  };
+
+  put(std::to_string(dependencies.size()));
+  for (const auto &[name, digest] : dependencies) {
+    put(name);
+    put(digest);
+  }
+  put(rendered);
+
+  return entry;
+}
+
+static auto TakeField(std::string_view &rest) -> std::optional<std::string_view> {
+  size_t length = 0;
+  auto [ptr, ec] = std::from_chars(rest.data(), rest.data() + rest.size(), length);
+  if (ec != std::errc() || ptr == rest.data() + rest.size() || *ptr != ':') [[unlikely]] {
+    return std::nullopt;
+  }
+
+  rest.remove_prefix(ptr - rest.data() + 1);
+  if (length > rest.size()) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  auto field = rest.substr(0, length);
+  rest.remove_prefix(length);
+
+  return field;
+}
+
+static auto GetDependencyDigest(const std::optional<std::string> &content) -> std::string {
+  /* A missing resource has an empty digest */
+  if (!content) {
+    return "";
+  }
+
+  FieldHasher hasher;
+  hasher.Feed(*content);
+  const auto digest = hasher.Digest();
+
+  return {digest.begin(), digest.end()};
+}
+
+static auto FetchDependency(SequencerPImpl &shared, const std::string &module_name) -> std::optional<std::string> {
+  const auto jobid = std::string(shared.m_env->Get("this.job").value());
+  auto content = shared.m_fetch_module("file:///package/" + jobid + "/" + module_name);
+
+  /* Every import being rendered depends on this resource, directly or not */
+  if (!shared.m_imports.empty()) {
+    const auto digest = GetDependencyDigest(content);
+    for (auto &dependencies : shared.m_imports) {
+      dependencies.try_emplace(module_name, digest);
+    }
+  }
+
+  return content;
+}
+
+static auto ReadCachedImport(SequencerPImpl &shared, const ResourceKey &key) -> std::optional<std::string> {
+  std::string entry;
+  if (!GetCache().Read(key, entry)) {
+    return std::nullopt;
+  }
+
+  std::string_view rest = entry;
+  const auto count_field = TakeField(rest);
+  size_t count = 0;
+  if (!count_field ||
+      std::from_chars(count_field->data(), count_field->data() + count_field->size(), count).ec != std::errc())
+      [[unlikely]] {
+    return std::nullopt;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    const auto name = TakeField(rest);
+    const auto digest = TakeField(rest);
+    if (!name || !digest) [[unlikely]] {
+      return std::nullopt;
+    }
+
+    if (GetDependencyDigest(FetchDependency(shared, std::string(*name))) != *digest) {
+      Log << SeqLog << Debug << "Cached interface is stale: '" << *name << "' changed";
+      return std::nullopt;
+    }
+  }
+
+  const auto rendered = TakeField(rest);
+  if (!rendered || !rest.empty()) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  return std::string(*rendered);
+}
+
 auto Sequencer::RenderTranslationUnitSource(Sequencer &self, std::string_view source) -> std::optional<std::string> {
   std::stringstream output;
 
@@ -142,7 +680,12 @@ auto Sequencer::RenderTranslationUnitSource(Sequencer &self, std::string_view so
     }
 
     auto pool = DynamicArena();
-    const auto ast_root = GeneralParser::Create(*sub_scanner, self.m_env, pool)->Parse();
+    auto parser = GeneralParser::Create(*sub_scanner, self.m_env, pool);
+
+    /* Only declarations are rendered, so most bodies are never parsed */
+    parser->SetLazyBodies(true);
+
+    const auto ast_root = parser->Parse();
     if (!ast_root.Check()) [[unlikely]] {
       Log << SeqLog << "Failed to parse translation unit";
       return std::nullopt;
@@ -150,15 +693,26 @@ auto Sequencer::RenderTranslationUnitSource(Sequencer &self, std::string_view so
 
     /// TODO: Replace definitions with declarations
 
-    for_each<Function>(ast_root.Get(), [](auto node) {
-      auto function = node.template As<Function>();
-      function->SetBody(nullptr);
-    });
-
     /// FIXME: Fix this
-    for_each<Variable>(ast_root.Get(), [](auto node) {
-      auto variable = node.template As<Variable>();
-      variable->SetInitializer(nullptr);
+    /* Strip whatever the parser could not defer, such as `=>` bodies.
+     * Children are gathered after the callback, so stripped bodies and
+     * initializers are never walked. */
+    for_each(ast_root.Get(), [](const FlowPtr<Expr> &node) {
+      switch (node->GetKind()) {
+        case QAST_FUNCTION: {
+          node.As<Function>()->SetBody(nullptr);
+          break;
+        }
+
+        case QAST_VAR: {
+          node.As<Variable>()->SetInitializer(nullptr);
+          break;
+        }
+
+        default: {
+          break;
+        }
+      }
     });
 
     auto writer = CodeWriterFactory::Create(output);
@@ -169,27 +723,50 @@ auto Sequencer::RenderTranslationUnitSource(Sequencer &self, std::string_view so
 }
 
 auto Sequencer::FetchModuleData(Sequencer &self, std::string_view raw_module_name) -> std::optional<std::string> {
+  auto &shared = *self.m_shared;
   auto module_name = std::string(raw_module_name);
 
-  const auto get_fetch_uri = [](const std::string &module_name, const std::string &jobid) {
-    return "file:///package/" + jobid + "/" + module_name;
-  };
-
   /* Translate module names into their actual names */
   if (const auto actual_name = self.m_env->Get("map." + module_name)) {
     module_name = actual_name.value();
   }
 
-  const auto jobid = std::string(self.m_env->Get("this.job").value());
-  const auto module_uri = get_fetch_uri(module_name, jobid);
-
   Log << SeqLog << Debug << "Importing module: '" << module_name << "'...";
 
-  if (const auto module_content = self.m_shared->m_fetch_module(module_uri)) {
+  const auto module_content = FetchDependency(shared, module_name);
+  if (!module_content) {
+    Log << SeqLog << "Import not found: '" << module_name << "'";
+    return std::nullopt;
+  }
+
+  /* Hashing the state walks all of it, so skip it when nothing is cached */
+  if (!GetCache().IsBound()) {
+    return RenderTranslationUnitSource(self, module_content.value());
+  }
+
+  const auto state = GetStateDigest(shared);
+  if (!state) [[unlikely]] {
+    Log << SeqLog << Debug << "Not caching module '" << module_name << "': the Lua state is nested too deeply";
     return RenderTranslationUnitSource(self, module_content.value());
   }
 
-  Log << SeqLog << "Import not found: '" << module_name << "'";
+  const auto key = GetImportCacheKey(module_content.value(), *state);
 
-  return std::nullopt;
+  if (auto rendered = ReadCachedImport(shared, key)) {
+    Log << SeqLog << Debug << "Using cached interface for module: '" << module_name << "'";
+    return rendered;
+  }
+
+  shared.m_imports.emplace_back();
+  auto rendered = RenderTranslationUnitSource(self, module_content.value());
+  const auto dependencies = std::move(shared.m_imports.back());
+  shared.m_imports.pop_back();
+
+  /* A cache hit skips the macros of the module, so only renderings without
+   * side effects on the state are reusable */
+  if (rendered.has_value() && GetStateDigest(shared) == state) {
+    GetCache().Write(key, EncodeCachedImport(dependencies, rendered.value()));
+  }
+
+  return rendered;
 }
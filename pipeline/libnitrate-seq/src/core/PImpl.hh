@@ -34,24 +34,113 @@
 #ifndef __NITRATE_SEQ_PIMPL_H__
 #define __NITRATE_SEQ_PIMPL_H__
 
+#include <chrono>
+#include <cstdint>
 #include <list>
+#include <map>
+#include <memory>
+#include <nitrate-core/Cache.hh>
 #include <nitrate-seq/Sequencer.hh>
-#include <queue>
+#include <optional>
 #include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ncc::seq {
+  /* Accumulated cost of every expansion of one macro within a job */
+  struct MacroProfile {
+    uint64_t m_calls = 0;
+    uint64_t m_instructions = 0;
+    uint64_t m_tokens = 0;
+    std::chrono::nanoseconds m_time{0};
+  };
+
+  /**
+   * Pending output of a macro. Emitted source is lexed lazily while the
+   * parser consumes it; tokens emitted from Lua are replayed as they are.
+   */
+  class Expansion {
+    std::string m_source;
+    std::optional<lex::Tokenizer> m_scanner;
+    std::vector<lex::Token> m_tokens;
+    size_t m_next = 0;
+    MacroProfile* m_profile = nullptr;
+
+  public:
+    Expansion() = default;
+    Expansion(std::string source, std::shared_ptr<IEnvironment> env) : m_source(std::move(source)) {
+      m_scanner.emplace(m_source, std::move(env));
+    }
+    Expansion(const Expansion&) = delete;
+    Expansion(Expansion&&) = delete;
+
+    [[nodiscard]] auto IsSource() const -> bool { return m_scanner.has_value(); }
+    [[nodiscard]] auto HasError() const -> bool { return m_scanner.has_value() && m_scanner->HasError(); }
+
+    auto Push(lex::Token tok) -> void { m_tokens.push_back(tok); }
+    auto SetProfile(MacroProfile* profile) -> void { m_profile = profile; }
+
+    auto Next() -> lex::Token {
+      auto tok = m_scanner.has_value() ? m_scanner->Next()
+                                       : (m_next < m_tokens.size() ? m_tokens[m_next++] : lex::Token::EndOfFile());
+
+      if (m_profile != nullptr && !tok.Is(lex::EofF)) {
+        m_profile->m_tokens++;
+      }
+
+      return tok;
+    }
+  };
+
+  /* Resources fetched while rendering an import, mapped to their content
+   * digest. A resource that was not found has an empty digest. */
+  using ImportDependencies = std::map<std::string, std::string>;
+
   class SequencerPImpl {
   public:
+    /* A macro that is currently executing */
+    struct ActiveMacro {
+      MacroProfile* m_profile;
+      uint64_t m_instructions;
+      std::chrono::steady_clock::time_point m_start;
+    };
+
     std::mt19937 m_random;
-    std::queue<std::queue<lex::Token>> m_emission;
+    /* Output of the macros currently executing, innermost last */
+    std::vector<std::vector<std::unique_ptr<Expansion>>> m_pending;
+    std::vector<ActiveMacro> m_active;
     FetchModuleFunc m_fetch_module;
     std::list<MethodType> m_captures;
+
+    /* Registry references to compiled macro bodies, keyed by source text */
+    std::unordered_map<std::string, int> m_chunks;
+
+    /* Lua instructions executed by this job, counted by the VM hook */
+    uint64_t m_instructions = 0;
+    /* Limit on m_instructions; zero means unlimited */
+    uint64_t m_instruction_budget = 0;
+    /* Keyed by macro name, or by the leading text of a macro block */
+    std::unordered_map<std::string, MacroProfile> m_profile;
+
+    /* Dependencies of the imports currently being rendered, innermost last */
+    std::vector<ImportDependencies> m_imports;
+
     std::shared_ptr<IEnvironment> m_env;
     lua_State* m_L;
     size_t m_depth;
 
+    /* Sequencer that the bound API functions act on */
+    Sequencer* m_owner = nullptr;
+    bool m_initialized = false;
+    /* Registry reference to the pristine globals of a pooled state */
+    std::optional<int> m_globals;
+
     SequencerPImpl(std::shared_ptr<IEnvironment> env);
     ~SequencerPImpl();
+
+    auto SnapshotGlobals() -> void;
+    auto Reset() -> void;
   };
 }  // namespace ncc::seq
 
@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <core/PImpl.hh>
+#include <memory>
+#include <mutex>
+#include <nitrate-seq/Sequencer.hh>
+#include <vector>
+
+extern "C" {
+#include <lua/lauxlib.h>
+#include <lua/lua.h>
+}
+
+using namespace ncc::seq;
+
+/* A pooled state drops its compiled chunks once it has accumulated this many */
+static constexpr size_t kMaxPooledChunks = 4096;
+
+/* Slots of the snapshot table referenced by SequencerPImpl::m_globals */
+static constexpr lua_Integer kSnapshotTables = 1;
+static constexpr lua_Integer kSnapshotMetatables = 2;
+static constexpr lua_Integer kSnapshotStringMetatable = 3;
+
+static void EnqueueTable(lua_State *lua, int pending, lua_Integer &count, int value) {
+  if (lua_istable(lua, value)) {
+    lua_pushvalue(lua, value);
+    lua_rawseti(lua, pending, ++count);
+  }
+}
+
+static void SnapshotTable(lua_State *lua, int tables, int metatables, int table) {
+  /* tables[table] = shallow copy of table */
+  lua_pushvalue(lua, table);
+  lua_newtable(lua);
+  lua_pushnil(lua);
+  while (lua_next(lua, table) != 0) {
+    lua_pushvalue(lua, -2);
+    lua_pushvalue(lua, -2);
+    lua_rawset(lua, -5);
+    lua_pop(lua, 1);
+  }
+  lua_rawset(lua, tables);
+
+  /* metatables[table] = metatable of table, if any */
+  if (lua_getmetatable(lua, table) != 0) {
+    lua_pushvalue(lua, table);
+    lua_insert(lua, -2);
+    lua_rawset(lua, metatables);
+  }
+}
+
+static void RestoreTable(lua_State *lua, int live, int copy, int metatables) {
+  /* Drop every key the job added. Clearing fields while traversing is allowed. */
+  lua_pushnil(lua);
+  while (lua_next(lua, live) != 0) {
+    lua_pop(lua, 1);
+    lua_pushvalue(lua, -1);
+    if (lua_rawget(lua, copy) == LUA_TNIL) {
+      lua_pushvalue(lua, -2);
+      lua_pushnil(lua);
+      lua_rawset(lua, live);
+    }
+    lua_pop(lua, 1);
+  }
+
+  /* Put back every value the job replaced or removed */
+  lua_pushnil(lua);
+  while (lua_next(lua, copy) != 0) {
+    lua_pushvalue(lua, -2);
+    lua_insert(lua, -2);
+    lua_rawset(lua, live);
+  }
+
+  /* The C API bypasses a `__metatable` field, so protected tables are reset too */
+  lua_pushvalue(lua, live);
+  lua_rawget(lua, metatables);
+  lua_setmetatable(lua, live);
+}
+
+auto SequencerPImpl::SnapshotGlobals() -> void {
+  /**
+   * Record every table reachable from the globals or from the string
+   * metatable, which lives in the registry, along with the metatables of
+   * those tables. Restoring them later undoes anything a job did to the
+   * environment. Upvalues are not followed; the prelude keeps no state in
+   * them.
+   */
+
+  lua_settop(m_L, 0);
+  lua_createtable(m_L, 3, 0); /* 1: snapshot */
+  lua_newtable(m_L);          /* 2: live table -> copy */
+  lua_newtable(m_L);          /* 3: live table -> metatable */
+  lua_newtable(m_L);          /* 4: tables left to visit */
+  lua_Integer pending = 0;
+
+  lua_pushglobaltable(m_L);
+  EnqueueTable(m_L, 4, pending, 5);
+  lua_pop(m_L, 1);
+
+  lua_pushstring(m_L, "");
+  if (lua_getmetatable(m_L, -1) != 0) {
+    EnqueueTable(m_L, 4, pending, 6);
+    lua_rawseti(m_L, 1, kSnapshotStringMetatable);
+  }
+  lua_pop(m_L, 1);
+
+  while (pending > 0) {
+    lua_rawgeti(m_L, 4, pending);
+    lua_pushnil(m_L);
+    lua_rawseti(m_L, 4, pending--);
+
+    lua_pushvalue(m_L, 5);
+    if (lua_rawget(m_L, 2) != LUA_TNIL) {
+      lua_pop(m_L, 2);
+      continue;
+    }
+    lua_pop(m_L, 1);
+
+    SnapshotTable(m_L, 2, 3, 5);
+
+    lua_pushnil(m_L);
+    while (lua_next(m_L, 5) != 0) {
+      EnqueueTable(m_L, 4, pending, 6);
+      EnqueueTable(m_L, 4, pending, 7);
+      lua_pop(m_L, 1);
+    }
+
+    if (lua_getmetatable(m_L, 5) != 0) {
+      EnqueueTable(m_L, 4, pending, 6);
+      lua_pop(m_L, 1);
+    }
+
+    lua_pop(m_L, 1);
+  }
+
+  lua_settop(m_L, 3);
+  lua_rawseti(m_L, 1, kSnapshotMetatables);
+  lua_rawseti(m_L, 1, kSnapshotTables);
+  m_globals = luaL_ref(m_L, LUA_REGISTRYINDEX);
+}
+
+auto SequencerPImpl::Reset() -> void {
+  lua_settop(m_L, 0);
+  lua_rawgeti(m_L, LUA_REGISTRYINDEX, m_globals.value());
+  lua_rawgeti(m_L, 1, kSnapshotTables);
+  lua_rawgeti(m_L, 1, kSnapshotMetatables);
+
+  lua_pushstring(m_L, "");
+  lua_rawgeti(m_L, 1, kSnapshotStringMetatable);
+  lua_setmetatable(m_L, -2);
+  lua_pop(m_L, 1);
+
+  lua_pushnil(m_L);
+  while (lua_next(m_L, 2) != 0) {
+    RestoreTable(m_L, 4, 5, 3);
+    lua_pop(m_L, 1);
+  }
+
+  /* A job may have stopped the collector or switched it to generational mode */
+  lua_gc(m_L, LUA_GCRESTART);
+  lua_gc(m_L, LUA_GCINC, 0, 0, 0);
+
+  lua_settop(m_L, 0);
+
+  if (m_chunks.size() > kMaxPooledChunks) [[unlikely]] {
+    for (const auto &[_, ref] : m_chunks) {
+      luaL_unref(m_L, LUA_REGISTRYINDEX, ref);
+    }
+    m_chunks.clear();
+  }
+
+  m_random.seed(0);
+  m_pending.clear();
+  m_active.clear();
+  m_fetch_module = FileSystemFetchModule;
+  m_instructions = 0;
+  m_instruction_budget = 0;
+  m_profile.clear();
+  m_imports.clear();
+  m_env.reset();
+  m_depth = 0;
+  m_owner = nullptr;
+}
+
+class SequencerPool::Impl : public std::enable_shared_from_this<Impl> {
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<SequencerPImpl>> m_idle;
+  size_t m_max_idle;
+
+  auto Release(std::unique_ptr<SequencerPImpl> state) -> void {
+    /* States whose prelude did not run to completion are not reusable */
+    if (!state->m_globals.has_value()) [[unlikely]] {
+      return;
+    }
+
+    {
+      std::lock_guard lock(m_mutex);
+      if (m_idle.size() >= m_max_idle) {
+        return;
+      }
+    }
+
+    state->Reset();
+
+    std::lock_guard lock(m_mutex);
+    if (m_idle.size() < m_max_idle) {
+      m_idle.push_back(std::move(state));
+    }
+  }
+
+public:
+  explicit Impl(size_t max_idle) : m_max_idle(max_idle) {}
+
+  auto Acquire(std::shared_ptr<ncc::IEnvironment> env) -> std::shared_ptr<SequencerPImpl> {
+    std::unique_ptr<SequencerPImpl> state;
+
+    {
+      std::lock_guard lock(m_mutex);
+      if (!m_idle.empty()) {
+        state = std::move(m_idle.back());
+        m_idle.pop_back();
+      }
+    }
+
+    if (state) {
+      state->m_env = std::move(env);
+    } else {
+      state = std::make_unique<SequencerPImpl>(std::move(env));
+    }
+
+    return {state.release(), [pool = weak_from_this()](SequencerPImpl *ptr) {
+              std::unique_ptr<SequencerPImpl> owned(ptr);
+              if (auto impl = pool.lock()) {
+                impl->Release(std::move(owned));
+              }
+            }};
+  }
+
+  [[nodiscard]] auto GetIdleCount() const -> size_t {
+    std::lock_guard lock(m_mutex);
+    return m_idle.size();
+  }
+};
+
+SequencerPool::SequencerPool(size_t max_idle) : m_impl(std::make_shared<Impl>(max_idle)) {}
+
+SequencerPool::~SequencerPool() = default;
+
+auto SequencerPool::Create(std::istream &file, std::shared_ptr<IEnvironment> env) -> std::unique_ptr<Sequencer> {
+  auto sequencer = std::unique_ptr<Sequencer>(new Sequencer(file, m_impl->Acquire(std::move(env))));
+  Sequencer::Initialize(*sequencer);
+
+  /* If the prelude fell back to source it has not run yet, so the state is
+   * not snapshotted and will not be pooled. */
+  auto &shared = *sequencer->m_shared;
+  if (!shared.m_globals.has_value() && sequencer->m_frames.empty()) {
+    shared.SnapshotGlobals();
+  }
+
+  return sequencer;
+}
+
+auto SequencerPool::GetIdleCount() const -> size_t { return m_impl->GetIdleCount(); }
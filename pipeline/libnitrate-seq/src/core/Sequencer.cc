@@ -31,16 +31,23 @@
 ///                                                                          ///
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <boost/iostreams/device/array.hpp>
-#include <boost/iostreams/stream.hpp>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <core/EC.hh>
 #include <core/PImpl.hh>
 #include <iostream>
 #include <memory>
+#include <nitrate-core/Environment.hh>
 #include <nitrate-core/Logger.hh>
 #include <nitrate-core/Macro.hh>
+#include <nitrate-lexer/Lexer.hh>
 #include <nitrate-lexer/Scanner.hh>
 #include <nitrate-seq/Sequencer.hh>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
 
 extern "C" {
 #include <lua/lauxlib.h>
@@ -60,31 +67,146 @@ static const std::array LUA_AUTOLOAD_WHITELIST = {
     luaL_Reg{LUA_UTF8LIBNAME, luaopen_utf8},  /* UTF-8 manipulation */
 };
 
+static constexpr size_t kMaxRecursionDepth = 10000;
+static constexpr int kInstructionHookInterval = 128;
+static constexpr size_t kProfileKeyLength = 48;
+
+static constexpr std::string_view kSecureLibsPatch = R"(@(
+  -- From lbaselib.c
+  dofile = nil;
+  loadfile = nil;
+
+  print = function(...)
+    local args = {...};
+    local res = '';
+    for i = 1, #args do
+      res = res .. tostring(args[i]);
+      if i < #args then
+        res = res .. '\t';
+      end
+    end
+    n.info(res);
+  end
+
+  -- From lmathlib.c
+  math.random = n.random;
+  math.randomseed = function() n.warn("math.randomseed is a no-op") end;
+))";
+
+/**
+ * Compile every macro block of a source that consists of nothing but macro
+ * blocks into Lua bytecode. Returns std::nullopt if the source contains any
+ * other token or a block fails to compile; such sources have to go through
+ * the sequencer like regular input.
+ */
+static auto PrecompileMacroBlocks(std::string_view source,
+                                  std::shared_ptr<ncc::IEnvironment> env) -> std::optional<std::vector<std::string>> {
+  auto *lua = luaL_newstate();
+  if (lua == nullptr) [[unlikely]] {
+    return std::nullopt;
+  }
+
+  std::vector<std::string> chunks;
+  Tokenizer tokenizer(source, std::move(env));
+  bool ok = true;
+
+  for (auto tok = tokenizer.Next(); ok && !tok.Is(EofF); tok = tokenizer.Next()) {
+    if (!tok.Is(MacB)) [[unlikely]] {
+      ok = false;
+      break;
+    }
+
+    /* Use the same chunk name as luaL_dostring so diagnostics are unchanged */
+    const auto &code = tok.GetString().Get();
+    if (luaL_loadbuffer(lua, code.data(), code.size(), code.c_str()) != LUA_OK) [[unlikely]] {
+      ok = false;
+      break;
+    }
+
+    lua_dump(
+        lua,
+        [](lua_State *, const void *p, size_t sz, void *ud) {
+          static_cast<std::string *>(ud)->append(static_cast<const char *>(p), sz);
+          return 0;
+        },
+        &chunks.emplace_back(), 0);
+    lua_pop(lua, 1);
+  }
+
+  ok = ok && !tokenizer.HasError();
+  lua_close(lua);
+
+  return ok ? std::optional(std::move(chunks)) : std::nullopt;
+}
+
+static void InstructionHook(lua_State *lua, lua_Debug *) {
+  auto &shared = **static_cast<SequencerPImpl **>(lua_getextraspace(lua));
+  shared.m_instructions += kInstructionHookInterval;
+
+  if (shared.m_instruction_budget != 0 && shared.m_instructions > shared.m_instruction_budget) [[unlikely]] {
+    luaL_error(lua, "instruction budget of %I exceeded", static_cast<lua_Integer>(shared.m_instruction_budget));
+  }
+}
+
+static auto GetInstructionBudget(const std::shared_ptr<ncc::IEnvironment> &env) -> uint64_t {
+  uint64_t budget = 0;
+
+  if (auto value = env->Get("seq.instruction-budget")) {
+    const auto text = std::string(value.value());
+    if (std::from_chars(text.data(), text.data() + text.size(), budget).ec != std::errc()) [[unlikely]] {
+      ncc::Log << SeqLog << "Invalid instruction budget: " << text;
+      budget = 0;
+    }
+  }
+
+  return budget;
+}
+
+static auto GetProfileKey(std::string_view code) -> std::string {
+  /* Macro blocks are identified by their first line */
+  auto line = code.substr(0, code.find('\n'));
+  line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+
+  if (line.size() > kProfileKeyLength) {
+    return "@(" + std::string(line.substr(0, kProfileKeyLength)) + "...)";
+  }
+
+  return "@(" + std::string(line) + ")";
+}
+
+static auto IsLuaName(std::string_view name) -> bool {
+  const auto is_name_char = [](char c) { return std::isalnum(static_cast<uint8_t>(c)) || c == '_'; };
+
+  return !name.empty() && std::isdigit(static_cast<uint8_t>(name.front())) == 0 &&
+         std::all_of(name.begin(), name.end(), is_name_char);
+}
+
 void Sequencer::BindMethod(Sequencer &self, const char *name, MethodType func) noexcept {
   /**
    * This function binds a C++ method to a LUA function.
    * The process is as follows:
    *
-   * 1. Cast a pointer to `this` and to the `method` to `lua_Integer`.
+   * 1. Cast a pointer to the shared state and to the `method` to `lua_Integer`.
    * 2. Push these values onto the LUA stack.
    * 3. Then, create a closure that closes over these values.
    * 4. Inside the closure, reinterpret the abovementioned values back to their
-   *    original types and invoke them as a indirect method call.
+   *    original types and invoke them as a indirect method call on the
+   *    current owner of the state. Pooled states change owners between jobs.
    */
 
   auto s = self.m_shared;
 
   const auto &func_ref = s->m_captures.emplace_back(func);
-  lua_pushinteger(s->m_L, reinterpret_cast<lua_Integer>(&self));
+  lua_pushinteger(s->m_L, reinterpret_cast<lua_Integer>(s.get()));
   lua_pushinteger(s->m_L, reinterpret_cast<lua_Integer>(&func_ref));
 
   lua_pushcclosure(
       s->m_L,
       [](auto lua) {
         const auto method_ptr_integer = lua_tointeger(lua, lua_upvalueindex(2));
-        const auto self_ptr_integer = lua_tointeger(lua, lua_upvalueindex(1));
+        const auto shared_ptr_integer = lua_tointeger(lua, lua_upvalueindex(1));
         const auto &method_ref = *reinterpret_cast<MethodType *>(method_ptr_integer);
-        auto &self_ref = *reinterpret_cast<Sequencer *>(self_ptr_integer);
+        auto &self_ref = *reinterpret_cast<SequencerPImpl *>(shared_ptr_integer)->m_owner;
 
         // Indirect method call
         auto rc = (self_ref.*method_ref)();
@@ -104,6 +226,7 @@ void Sequencer::AttachAPIFunctions(Sequencer &self) noexcept {
    *  | next  | Fetch the next token from the input stream                      |
    *  | peek  | Peek at the next token without consuming it                     |
    *  | emit  | Recursively apply preprocessing to a string                     |
+   *  | emit_tok | Emit a token given as a {ty=..., v=...} table                |
    *  | debug | Log a debug message to the console                              |
    *  | info  | Log an informational message to the console                     |
    *  | warn  | Log a warning message to the console                            |
@@ -129,6 +252,7 @@ void Sequencer::AttachAPIFunctions(Sequencer &self) noexcept {
     BindMethod(self, "next", &Sequencer::SysNext);
     BindMethod(self, "peek", &Sequencer::SysPeek);
     BindMethod(self, "emit", &Sequencer::SysEmit);
+    BindMethod(self, "emit_tok", &Sequencer::SysEmitTok);
 
     /* Logging API */
     BindMethod(self, "debug", &Sequencer::SysDebug);
@@ -170,35 +294,35 @@ void Sequencer::LoadSecureLibs(Sequencer &self) noexcept {
   }
 
   /* Disable some lua functions for security and determinism */
-  SequenceSource(self,
-                 R"(@(
-  -- From lbaselib.c
-  dofile = nil;
-  loadfile = nil;
+  static const auto kBytecode = PrecompileMacroBlocks(kSecureLibsPatch, self.m_env);
+  SequencePrecompiled(self, kSecureLibsPatch, kBytecode);
+}
 
-  print = function(...)
-    local args = {...};
-    local res = '';
-    for i = 1, #args do
-      res = res .. tostring(args[i]);
-      if i < #args then
-        res = res .. '\t';
-      end
-    end
-    n.info(res);
-  end
+auto Sequencer::LoadCachedChunk(Sequencer &self, const std::string &code) -> bool {
+  auto &shared = *self.m_shared;
+  auto *lua = shared.m_L;
 
-  -- From lmathlib.c
-  math.random = n.random;
-  math.randomseed = function() n.warn("math.randomseed is a no-op") end;
-))");
+  if (auto it = shared.m_chunks.find(code); it != shared.m_chunks.end()) [[likely]] {
+    lua_rawgeti(lua, LUA_REGISTRYINDEX, it->second);
+    return true;
+  }
+
+  /* Use the code as chunk name, like luaL_dostring does */
+  if (luaL_loadbuffer(lua, code.data(), code.size(), code.c_str()) != LUA_OK) [[unlikely]] {
+    return false;
+  }
+
+  lua_pushvalue(lua, -1);
+  shared.m_chunks.emplace(code, luaL_ref(lua, LUA_REGISTRYINDEX));
+
+  return true;
 }
 
-auto Sequencer::ExecuteLua(Sequencer &self, const char *code) -> std::optional<std::string> {
+auto Sequencer::CallLuaFunction(Sequencer &self, bool keep_results) -> std::optional<std::string> {
   auto *lua = self.m_shared->m_L;
-  const auto old_stack_size = lua_gettop(lua);
+  const auto old_stack_size = lua_gettop(lua) - 1;
 
-  if (luaL_dostring(lua, code)) [[unlikely]] {
+  if (lua_pcall(lua, 0, keep_results ? LUA_MULTRET : 0, 0) != LUA_OK) [[unlikely]] {
     Log << SeqLog << "Lua error: " << lua_tostring(lua, -1);
     self.SetFailBit();
 
@@ -206,14 +330,45 @@ auto Sequencer::ExecuteLua(Sequencer &self, const char *code) -> std::optional<s
   }
 
   const auto new_stack_size = lua_gettop(lua);
-  const auto any_return = new_stack_size != old_stack_size;
+  if (new_stack_size == old_stack_size || lua_isnil(lua, -1)) {
+    return "";
+  }
+
+  if (!lua_isstring(lua, -1)) [[unlikely]] {
+    Log << SeqLog << "Macro returned a " << luaL_typename(lua, -1) << " instead of a string";
+    self.SetFailBit();
 
-  return any_return ? std::optional<std::string>(lua_tostring(lua, -1)) : "";
+    return std::nullopt;
+  }
+
+  return lua_tostring(lua, -1);
 }
 
-auto Sequencer::CreateChild(Sequencer &self, std::istream &file) -> std::unique_ptr<Sequencer> {
-  static constexpr auto kMaxRecursionDepth = 10000;
+auto Sequencer::ExecuteLua(Sequencer &self, const std::string &code) -> std::optional<std::string> {
+  if (!LoadCachedChunk(self, code)) [[unlikely]] {
+    Log << SeqLog << "Lua error: " << lua_tostring(self.m_shared->m_L, -1);
+    self.SetFailBit();
+
+    return std::nullopt;
+  }
+
+  return CallLuaFunction(self, true);
+}
+
+auto Sequencer::ExecuteBytecode(Sequencer &self, std::string_view bytecode) -> std::optional<std::string> {
+  auto *lua = self.m_shared->m_L;
+
+  if (luaL_loadbufferx(lua, bytecode.data(), bytecode.size(), "=prelude", "b") != LUA_OK) [[unlikely]] {
+    Log << SeqLog << "Lua error: " << lua_tostring(lua, -1);
+    self.SetFailBit();
 
+    return std::nullopt;
+  }
+
+  return CallLuaFunction(self, true);
+}
+
+auto Sequencer::CreateChild(Sequencer &self, std::istream &file) -> std::unique_ptr<Sequencer> {
   auto clone = std::unique_ptr<Sequencer>(new Sequencer(file, self.m_shared));
   clone->m_shared->m_depth = self.m_shared->m_depth + 1;
 
@@ -225,35 +380,95 @@ auto Sequencer::CreateChild(Sequencer &self, std::istream &file) -> std::unique_
   return clone;
 }
 
-void Sequencer::SequenceSource(Sequencer &self, std::string_view code) {
+auto Sequencer::PushExpansion(Sequencer &self, std::unique_ptr<Expansion> expansion) -> bool {
+  if (self.m_frames.size() >= kMaxRecursionDepth) [[unlikely]] {
+    Log << SeqLog << "Maximum macro recursion depth reached, aborting";
+    self.SetFailBit();
+
+    return false;
+  }
+
+  self.m_frames.push_back(std::move(expansion));
+
+  return true;
+}
+
+void Sequencer::SequenceSource(Sequencer &self, std::string code) {
   /**
-   * Preprocess the given source code and push the tokens onto the emission queue.
+   * Queue the given source code in front of the remaining input. It is lexed
+   * lazily as tokens are requested, so an expansion is never materialized as
+   * a whole.
    */
 
-  auto ss = boost::iostreams::stream<boost::iostreams::array_source>(code.data(), code.size());
-  auto clone = CreateChild(self, ss);
-  if (!clone) [[unlikely]] {
+  PushExpansion(self, std::make_unique<Expansion>(std::move(code), self.m_env));
+}
+
+void Sequencer::BeginExpansion(Sequencer &self, std::string macro) {
+  auto &shared = *self.m_shared;
+  auto &profile = shared.m_profile[std::move(macro)];
+  profile.m_calls++;
+
+  shared.m_pending.emplace_back();
+  shared.m_active.push_back({&profile, shared.m_instructions, std::chrono::steady_clock::now()});
+}
+
+auto Sequencer::EndExpansion(Sequencer &self, std::optional<std::string> result) -> bool {
+  auto &shared = *self.m_shared;
+  auto emitted = std::move(shared.m_pending.back());
+  shared.m_pending.pop_back();
+
+  /* Nested macros are included in the cost of their caller */
+  const auto active = shared.m_active.back();
+  shared.m_active.pop_back();
+  active.m_profile->m_time += std::chrono::steady_clock::now() - active.m_start;
+  active.m_profile->m_instructions += shared.m_instructions - active.m_instructions;
+
+  if (!result) [[unlikely]] {
     self.SetFailBit();
+    return false;
+  }
 
-    /* Push an end-of-file token to the emission queue */
-    self.m_shared->m_emission.push(std::queue<Token>({Token::EndOfFile()}));
-    return;
+  /* The return value of a macro follows everything it emitted */
+  if (!result->empty()) {
+    emitted.push_back(std::make_unique<Expansion>(std::move(*result), self.m_env));
   }
 
-  std::queue<Token> q;
-  while (Token tok = clone->Next()) {
-    q.push(tok);
+  /* The frame on top of the stack is read first */
+  for (auto it = emitted.rbegin(); it != emitted.rend(); ++it) {
+    (*it)->SetProfile(active.m_profile);
+    if (!PushExpansion(self, std::move(*it))) [[unlikely]] {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Sequencer::SequencePrecompiled(Sequencer &self, std::string_view code,
+                                    const std::optional<std::vector<std::string>> &bytecode) {
+  /**
+   * Run precompiled macro blocks directly, skipping the tokenizer and the Lua
+   * compiler. Falls back to sequencing the source if it could not be compiled.
+   */
+
+  if (!bytecode) [[unlikely]] {
+    /* Keep the sources in the order they were requested in */
+    self.m_frames.insert(self.m_frames.begin(), std::make_unique<Expansion>(std::string(code), self.m_env));
+    return;
   }
 
-  if (!q.empty()) {
-    self.m_shared->m_emission.push(std::move(q));
+  for (const auto &chunk : *bytecode) {
+    BeginExpansion(self, "<prelude>");
+    if (!EndExpansion(self, ExecuteBytecode(self, chunk))) [[unlikely]] {
+      return;
+    }
   }
 }
 
 auto Sequencer::HandleImportDirective(Sequencer &self) -> bool {
-  const auto import_name = self.m_scanner.Next().AsString();
+  const auto import_name = self.NextRaw().AsString();
 
-  if (!self.m_scanner.Next().Is<PuncSemi>()) [[unlikely]] {
+  if (!self.NextRaw().Is<PuncSemi>()) [[unlikely]] {
     Log << SeqLog << "Expected a semicolon after import name";
     self.SetFailBit();
 
@@ -261,7 +476,7 @@ auto Sequencer::HandleImportDirective(Sequencer &self) -> bool {
   }
 
   if (auto content = FetchModuleData(self, import_name)) {
-    SequenceSource(self, content.value());
+    SequenceSource(self, std::move(content.value()));
   } else {
     self.SetFailBit();
   }
@@ -272,79 +487,88 @@ auto Sequencer::HandleImportDirective(Sequencer &self) -> bool {
 auto Sequencer::HandleMacroBlock(Sequencer &self, Token macro) -> bool {
   qcore_assert(macro.GetKind() == MacB);
 
-  if (auto result_data = ExecuteLua(self, macro.GetString()->c_str())) [[likely]] {
-    SequenceSource(self, result_data.value());
-    return true;
-  }
-
-  self.SetFailBit();
+  const auto &code = macro.GetString().Get();
+  BeginExpansion(self, GetProfileKey(code));
 
-  return false;
+  return EndExpansion(self, ExecuteLua(self, code));
 }
 
 auto Sequencer::HandleMacroStatement(Sequencer &self, Token macro) -> bool {
   qcore_assert(macro.GetKind() == Macr);
 
-  if (auto result_code = ExecuteLua(self, (std::string(macro.GetString()) + "()").c_str())) [[likely]] {
-    SequenceSource(self, result_code.value());
-    return true;
+  const auto &name = macro.GetString().Get();
+  auto *lua = self.m_shared->m_L;
+
+  /* A plain name refers to a global function, which can be called directly
+   * instead of compiling a "name()" chunk. Like that chunk, the call discards
+   * the return values of the function. */
+  bool direct = IsLuaName(name);
+  if (direct && lua_getglobal(lua, name.c_str()) != LUA_TFUNCTION) [[unlikely]] {
+    lua_pop(lua, 1);
+    direct = false;
   }
 
-  self.SetFailBit();
+  BeginExpansion(self, "@" + name);
+
+  return EndExpansion(self, direct ? CallLuaFunction(self, false) : ExecuteLua(self, name + "()"));
+}
+
+auto Sequencer::NextRaw() -> Token {
+  while (!m_frames.empty()) {
+    auto &frame = *m_frames.back();
+    if (auto tok = frame.Next(); !tok.Is(EofF)) [[likely]] {
+      return tok;
+    }
+
+    if (frame.HasError()) [[unlikely]] {
+      SetFailBit();
+    }
 
-  return false;
+    m_frames.pop_back();
+  }
+
+  return m_scanner.Next();
 }
 
 auto Sequencer::GetNext() -> Token {
   Token tok;
 
   while (true) {
-    if (!m_shared->m_emission.empty()) [[unlikely]] {
-      auto &emission = m_shared->m_emission.front();
-
-      tok = emission.front();
-      emission.pop();
+    switch (tok = NextRaw(); tok.GetKind()) {
+      case EofF:
+      case IntL:
+      case Text:
+      case Char:
+      case NumL:
+      case Oper:
+      case Punc:
+      case Name:
+      case Note:
+        [[likely]] { break; }
+
+      case KeyW: {
+        if (tok.GetKeyword() == Import && HandleImportDirective(*this)) [[unlikely]] {
+          continue;
+        }
 
-      if (emission.empty()) {
-        m_shared->m_emission.pop();
+        break;
       }
-    } else {
-      switch (tok = m_scanner.Next(); tok.GetKind()) {
-        case EofF:
-        case IntL:
-        case Text:
-        case Char:
-        case NumL:
-        case Oper:
-        case Punc:
-        case Name:
-        case Note:
-          [[likely]] { break; }
-
-        case KeyW: {
-          if (tok.GetKeyword() == Import && HandleImportDirective(*this)) [[unlikely]] {
-            continue;
-          }
 
+      case MacB: {
+        if (HandleMacroBlock(*this, tok)) [[likely]] {
+          continue;
+        } else {
+          tok = Token::EndOfFile();
           break;
         }
+      }
 
-        case MacB: {
-          if (HandleMacroBlock(*this, tok)) [[likely]] {
-            continue;
-          } else {
-            tok = Token::EndOfFile();
-            break;
-          }
-        }
-
-        case Macr: {
-          if (HandleMacroStatement(*this, tok)) [[likely]] {
-            continue;
-          } else {
-            tok = Token::EndOfFile();
-            break;
-          }
+      case Macr: {
+        if (HandleMacroStatement(*this, tok)) [[likely]] {
+          continue;
+        } else {
+          tok = Token::EndOfFile();
+          break;
         }
       }
     }
@@ -368,6 +592,10 @@ SequencerPImpl::SequencerPImpl(std::shared_ptr<ncc::IEnvironment> env)
     Log << Emergency << SeqLog << "Failed to create Lua state";
     qcore_panic("Failed to create LUA context");
   }
+
+  /* The count hook makes the budget independent of host speed */
+  *static_cast<SequencerPImpl **>(lua_getextraspace(m_L)) = this;
+  lua_sethook(m_L, InstructionHook, LUA_MASKCOUNT, kInstructionHookInterval);
 }
 
 SequencerPImpl::~SequencerPImpl() { lua_close(m_L); }
@@ -377,9 +605,28 @@ Sequencer::Sequencer(std::istream &file, std::shared_ptr<SequencerPImpl> shared)
 
 Sequencer::Sequencer(std::istream &file, std::shared_ptr<ncc::IEnvironment> env)
     : ncc::lex::IScanner(std::move(env)), m_scanner(file, m_env), m_shared(std::make_shared<SequencerPImpl>(m_env)) {
-  AttachAPIFunctions(*this);
-  LoadSecureLibs(*this);
-  SequenceSource(*this, SEQUENCER_DIALECT_CODE_PREFIX);
+  Initialize(*this);
+}
+
+void Sequencer::Initialize(Sequencer &self) {
+  auto &shared = *self.m_shared;
+
+  shared.m_owner = &self;
+  shared.m_instruction_budget = GetInstructionBudget(self.m_env);
+
+  /* A state taken from a pool already has the API and prelude loaded */
+  if (shared.m_initialized) {
+    return;
+  }
+
+  AttachAPIFunctions(self);
+  LoadSecureLibs(self);
+
+  /* The prelude is compiled once per process and replayed for every job */
+  static const auto kPreludeBytecode = PrecompileMacroBlocks(SEQUENCER_DIALECT_CODE_PREFIX, self.m_env);
+  SequencePrecompiled(self, SEQUENCER_DIALECT_CODE_PREFIX, kPreludeBytecode);
+
+  shared.m_initialized = true;
 }
 
 Sequencer::~Sequencer() = default;
@@ -395,6 +642,36 @@ auto Sequencer::SetFailBit(bool fail) -> bool {
   return old;
 }
 
+auto Sequencer::GetProfile() const -> std::string {
+  std::vector<std::pair<std::string_view, const MacroProfile *>> macros;
+  macros.reserve(m_shared->m_profile.size());
+  for (const auto &[name, profile] : m_shared->m_profile) {
+    macros.emplace_back(name, &profile);
+  }
+
+  /* Most expensive first */
+  std::sort(macros.begin(), macros.end(), [](const auto &a, const auto &b) {
+    return std::tie(b.second->m_instructions, a.first) < std::tie(a.second->m_instructions, b.first);
+  });
+
+  auto j = nlohmann::json::object();
+  j["instructions"] = m_shared->m_instructions;
+  j["instruction_budget"] = m_shared->m_instruction_budget;
+  j["macros"] = nlohmann::json::array();
+
+  for (const auto &[name, profile] : macros) {
+    j["macros"].push_back({
+        {"name", name},
+        {"calls", profile->m_calls},
+        {"time_ns", profile->m_time.count()},
+        {"instructions", profile->m_instructions},
+        {"tokens", profile->m_tokens},
+    });
+  }
+
+  return j.dump();
+}
+
 auto Sequencer::SetFetchFunc(FetchModuleFunc func) -> void {
   m_shared->m_fetch_module = func ? std::move(func) : FileSystemFetchModule;
 }
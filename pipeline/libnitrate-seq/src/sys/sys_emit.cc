@@ -32,7 +32,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <core/PImpl.hh>
+#include <memory>
 #include <nitrate-seq/Sequencer.hh>
+#include <string>
 
 extern "C" {
 #include <lua/lauxlib.h>
@@ -52,7 +54,13 @@ auto Sequencer::SysEmit() -> int {
     return luaL_error(lua, "expected string, got %s", lua_typename(lua, lua_type(lua, 1)));
   }
 
-  SequenceSource(*this, lua_tostring(lua, 1));
+  if (m_shared->m_pending.empty()) [[unlikely]] {
+    return luaL_error(lua, "emit called outside of a macro expansion");
+  }
+
+  size_t length = 0;
+  const auto *code = lua_tolstring(lua, 1, &length);
+  m_shared->m_pending.back().push_back(std::make_unique<Expansion>(std::string(code, length), m_env));
 
   return 0;
 }
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+///                                                                          ///
+///     .-----------------.    .----------------.     .----------------.     ///
+///    | .--------------. |   | .--------------. |   | .--------------. |    ///
+///    | | ____  _____  | |   | |     ____     | |   | |    ______    | |    ///
+///    | ||_   _|_   _| | |   | |   .'    `.   | |   | |   / ____ `.  | |    ///
+///    | |  |   \ | |   | |   | |  /  .--.  \  | |   | |   `'  __) |  | |    ///
+///    | |  | |\ \| |   | |   | |  | |    | |  | |   | |   _  |__ '.  | |    ///
+///    | | _| |_\   |_  | |   | |  \  `--'  /  | |   | |  | \____) |  | |    ///
+///    | ||_____|\____| | |   | |   `.____.'   | |   | |   \______.'  | |    ///
+///    | |              | |   | |              | |   | |              | |    ///
+///    | '--------------' |   | '--------------' |   | '--------------' |    ///
+///     '----------------'     '----------------'     '----------------'     ///
+///                                                                          ///
+///   * NITRATE TOOLCHAIN - The official toolchain for the Nitrate language. ///
+///   * Copyright (C) 2024 Wesley C. Jones                                   ///
+///                                                                          ///
+///   The Nitrate Toolchain is free software; you can redistribute it or     ///
+///   modify it under the terms of the GNU Lesser General Public             ///
+///   License as published by the Free Software Foundation; either           ///
+///   version 2.1 of the License, or (at your option) any later version.     ///
+///                                                                          ///
+///   The Nitrate Toolcain is distributed in the hope that it will be        ///
+///   useful, but WITHOUT ANY WARRANTY; without even the implied warranty of ///
+///   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU      ///
+///   Lesser General Public License for more details.                        ///
+///                                                                          ///
+///   You should have received a copy of the GNU Lesser General Public       ///
+///   License along with the Nitrate Toolchain; if not, see                  ///
+///   <https://www.gnu.org/licenses/>.                                       ///
+///                                                                          ///
+////////////////////////////////////////////////////////////////////////////////
+
+#include <core/PImpl.hh>
+#include <memory>
+#include <nitrate-lexer/Grammar.hh>
+#include <nitrate-seq/Sequencer.hh>
+#include <optional>
+#include <string_view>
+
+extern "C" {
+#include <lua/lauxlib.h>
+}
+
+using namespace ncc::lex;
+using namespace ncc::seq;
+
+static auto ParseTokenType(std::string_view name) -> std::optional<TokenType> {
+  for (auto ty = static_cast<uint8_t>(EofF); ty <= static_cast<uint8_t>(Note); ++ty) {
+    if (*to_string(static_cast<TokenType>(ty)) == name) {
+      return static_cast<TokenType>(ty);
+    }
+  }
+
+  return std::nullopt;
+}
+
+static auto MakeToken(TokenType ty, std::string_view value) -> std::optional<Token> {
+  switch (ty) {
+    case EofF:
+      return std::nullopt;
+
+    case KeyW: {
+      auto it = LEXICAL_KEYWORDS.left.find(std::string(value));
+      return it != LEXICAL_KEYWORDS.left.end() ? std::optional<Token>(Token(KeyW, it->second)) : std::nullopt;
+    }
+
+    case Oper: {
+      auto it = LEXICAL_OPERATORS.left.find(std::string(value));
+      return it != LEXICAL_OPERATORS.left.end() ? std::optional<Token>(Token(Oper, it->second)) : std::nullopt;
+    }
+
+    case Punc: {
+      auto it = LEXICAL_PUNCTORS.left.find(std::string(value));
+      return it != LEXICAL_PUNCTORS.left.end() ? std::optional<Token>(Token(Punc, it->second)) : std::nullopt;
+    }
+
+    case Name:
+    case IntL:
+    case NumL:
+    case Text:
+    case Char:
+    case MacB:
+    case Macr:
+    case Note:
+      return Token(ty, ncc::string(value));
+  }
+
+  return std::nullopt;
+}
+
+auto Sequencer::SysEmitTok() -> int {
+  auto *lua = m_shared->m_L;
+
+  auto nargs = lua_gettop(lua);
+  if (nargs != 1) {
+    return luaL_error(lua, "expected 1 argument, got %d", nargs);
+  }
+
+  if (!lua_istable(lua, 1)) {
+    return luaL_error(lua, "expected table, got %s", lua_typename(lua, lua_type(lua, 1)));
+  }
+
+  if (m_shared->m_pending.empty()) [[unlikely]] {
+    return luaL_error(lua, "emit_tok called outside of a macro expansion");
+  }
+
+  lua_getfield(lua, 1, "ty");
+  lua_getfield(lua, 1, "v");
+
+  if (lua_isstring(lua, -2) == 0 || lua_isstring(lua, -1) == 0) {
+    return luaL_error(lua, "expected string fields 'ty' and 'v'");
+  }
+
+  size_t length = 0;
+  const auto *value_ptr = lua_tolstring(lua, -1, &length);
+  const std::string_view type_name = lua_tostring(lua, -2);
+  const std::string_view value(value_ptr, length);
+
+  const auto type = ParseTokenType(type_name);
+  if (!type) {
+    return luaL_error(lua, "unknown token type '%s'", type_name.data());
+  }
+
+  const auto tok = MakeToken(*type, value);
+  if (!tok) {
+    return luaL_error(lua, "invalid value for token of type '%s'", type_name.data());
+  }
+
+  /* Consecutive tokens share one expansion frame */
+  auto &pending = m_shared->m_pending.back();
+  if (pending.empty() || pending.back()->IsSource()) {
+    pending.push_back(std::make_unique<Expansion>());
+  }
+
+  pending.back()->Push(tok.value());
+
+  return 0;
+}
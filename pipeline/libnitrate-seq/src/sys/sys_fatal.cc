@@ -44,14 +44,17 @@ using namespace ncc::seq;
 auto Sequencer::SysFatal() -> int {
   auto *lua = m_shared->m_L;
 
-  std::stringstream ss;
+  {
+    std::stringstream ss;
 
-  auto top = lua_gettop(lua);
-  for (auto i = 1; i <= top; i++) {
-    ss << lua_tostring(lua, i) << " ";
-  }
+    auto top = lua_gettop(lua);
+    for (auto i = 1; i <= top; i++) {
+      ss << lua_tostring(lua, i) << " ";
+    }
 
-  Log << ec::SeqLog << Critical << ec::SeqLog << ss.str();
+    Log << ec::SeqLog << Critical << ec::SeqLog << ss.str();
+  }
 
-  throw lex::detail::ScannerEOF();
+  /* Unwind the macro through Lua; the caller turns the error into end-of-file */
+  return luaL_error(lua, "preprocessing halted by a fatal error");
 }
@@ -40,6 +40,7 @@
 #include <nitrate-ir/Module.hh>
 #include <nitrate-ir/ToJson.hh>
 #include <nitrate-ir/ToMsgPack.hh>
+#include <nitrate-parser/ASTFlat.hh>
 #include <nitrate-parser/ASTReader.hh>
 #include <unordered_set>
 
@@ -63,10 +64,16 @@ CREATE_TRANSFORM(nit::nr) {
     out_mode = OutMode::MsgPack;
   }
 
-  std::string source_str(std::istreambuf_iterator<char>(source), {});
-
   auto pool = DynamicArena();
-  auto root = ncc::parse::AstReader(source_str, pool).Get();
+  NullableFlowPtr<parse::Expr> root;
+
+  /* No protobuf message starts with the flat magic: 'N' encodes an invalid wire type */
+  if (source.peek() == parse::flat::kMagic[0]) {
+    std::string source_str(std::istreambuf_iterator<char>(source), {});
+    root = parse::FlatAstReader(source_str, pool).Get();
+  } else {
+    root = parse::AstReader(source, pool).Get();
+  }
   if (!root.has_value()) {
     Log << "Failed to parse input.";
     return false;
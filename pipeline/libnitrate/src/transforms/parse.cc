@@ -42,6 +42,7 @@
 #include <nitrate-lexer/Grammar.hh>
 #include <nitrate-lexer/Scanner.hh>
 #include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTFlat.hh>
 #include <nitrate-parser/ASTWriter.hh>
 #include <nitrate-parser/Context.hh>
 #include <utility>
@@ -350,15 +351,19 @@ public:
 };
 
 CREATE_TRANSFORM(nit::parse) {
-  (void)opts;
+  const auto parallel = opts.contains("-fparallel");
 
   DeserializerAdapterLexer lexer(source, env);
-  auto pool = ncc::DynamicArena();
-  auto parser = GeneralParser::Create(lexer, env, pool);
+  auto pool = ncc::DynamicArena(parallel ? ncc::ArenaSync::PerThread : ncc::ArenaSync::Shared);
 
-  auto root = parser->Parse();
+  auto root =
+      parallel ? GeneralParser::ParseParallel(lexer, env, pool) : GeneralParser::Create(lexer, env, pool)->Parse();
 
-  output << root.Get()->Serialize();
+  if (opts.contains("-fuse-flat")) {
+    FlatAstWriter(output).Write(root.Get());
+  } else {
+    root.Get()->Serialize(output);
+  }
 
   return root.Check();
 }
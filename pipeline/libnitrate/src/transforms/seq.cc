@@ -33,8 +33,10 @@
 
 #include <nitrate/code.h>
 
+#include <algorithm>
 #include <core/SerialUtil.hh>
 #include <core/Transform.hh>
+#include <fstream>
 #include <nitrate-core/Environment.hh>
 #include <nitrate-core/Init.hh>
 #include <nitrate-seq/Sequencer.hh>
@@ -48,7 +50,12 @@ extern auto ImplUseMsgpack(IScanner *l, std::ostream &o) -> bool;
 extern auto ImplUseJson(IScanner *l, std::ostream &o) -> bool;
 
 CREATE_TRANSFORM(nit::seq) {
-  Sequencer scanner(source, env);
+  /* Concurrent transforms reuse initialized Lua states instead of paying
+   * for the setup of a fresh interpreter each time. */
+  static SequencerPool sequencers;
+
+  const auto sequencer = sequencers.Create(source, env);
+  auto &scanner = *sequencer;
 
   enum class OutMode {
     JSON,
@@ -64,10 +71,30 @@ CREATE_TRANSFORM(nit::seq) {
     out_mode = OutMode::MsgPack;
   }
 
+  /* -fprofile=<path> writes the macro profile of this job as JSON */
+  constexpr std::string_view kProfileOpt = "-fprofile=";
+  const auto profile_opt = std::find_if(opts.begin(), opts.end(), [&](const auto &opt) {
+    return opt.starts_with(kProfileOpt);
+  });
+
+  bool ok = false;
   switch (out_mode) {
     case OutMode::JSON:
-      return ImplUseJson(&scanner, output);
+      ok = ImplUseJson(&scanner, output);
+      break;
     case OutMode::MsgPack:
-      return ImplUseMsgpack(&scanner, output);
+      ok = ImplUseMsgpack(&scanner, output);
+      break;
   }
+
+  if (profile_opt != opts.end()) {
+    const auto path = profile_opt->substr(kProfileOpt.size());
+    std::ofstream profile(path, std::ios::binary | std::ios::trunc);
+    if (!profile || !(profile << scanner.GetProfile())) [[unlikely]] {
+      Log << "Failed to write macro profile to " << path;
+      return false;
+    }
+  }
+
+  return ok;
 }
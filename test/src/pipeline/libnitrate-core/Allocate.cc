@@ -2,6 +2,8 @@
 
 #include <nitrate-core/Allocate.hh>
 #include <nitrate-core/Init.hh>
+#include <thread>
+#include <vector>
 
 #pragma GCC diagnostic ignored "-Wnon-power-of-two-alignment"
 
@@ -84,3 +86,71 @@ TEST(Core, Arena_MemoryUsed) {
     EXPECT_LT(arena->GetSpaceManaged(), all_used);
   }
 }
+
+TEST(Core, Arena_PerThread_Concurrent) {
+  constexpr auto kThreads = 8;
+  constexpr auto kAllocations = 10000;
+
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    auto arena = std::make_unique<ncc::DynamicArena>(ncc::ArenaSync::PerThread);
+    EXPECT_EQ(arena->GetSync(), ncc::ArenaSync::PerThread);
+
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < kThreads; t++) {
+      threads.emplace_back([&arena, t]() {
+        for (auto i = 0; i < kAllocations; i++) {
+          auto* ptr = arena->allocate(4, 1);
+          memset(ptr, t, 4);
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    EXPECT_EQ(arena->GetSpaceUsed(), kThreads * kAllocations * 4);
+    auto all_used = arena->GetSpaceManaged();
+
+    arena->Reset();
+
+    EXPECT_EQ(arena->GetSpaceUsed(), 0);
+    EXPECT_LT(arena->GetSpaceManaged(), all_used);
+
+    auto ptr = reinterpret_cast<uintptr_t>(arena->allocate(4, 1));
+    ASSERT_NE(ptr, 0);
+    EXPECT_EQ(arena->GetSpaceUsed(), 4);
+  }
+}
+
+TEST(Core, Arena_Policy_Recycle) {
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    ncc::ArenaPolicy policy;
+    policy.m_growth_factor = 2;
+    policy.m_max_segment = 1024 * 1024;
+    policy.m_use_mmap = true;
+    policy.m_recycle_limit = 1024 * 1024 * 16;
+
+    auto arena = std::make_unique<ncc::DynamicArena>(ncc::ArenaSync::Shared, policy);
+
+    for (auto i = 0; i < 100'000; i++) {
+      auto ptr = reinterpret_cast<uintptr_t>(arena->allocate(32, 16));
+      ASSERT_NE(ptr, 0);
+      EXPECT_EQ(ptr % 16, 0);
+      memset(reinterpret_cast<void*>(ptr), 'A', 32);
+    }
+
+    EXPECT_EQ(arena->GetSpaceUsed(), 100'000 * 32);
+    auto all_used = arena->GetSpaceManaged();
+
+    arena->Reset();
+
+    /* The warmed segments are retained rather than returned to the system */
+    EXPECT_EQ(arena->GetSpaceUsed(), 0);
+    EXPECT_GE(arena->GetSpaceManaged() + 1024, all_used);
+
+    auto ptr = reinterpret_cast<uintptr_t>(arena->allocate(1024 * 1024 * 4));
+    ASSERT_NE(ptr, 0);
+    memset(reinterpret_cast<void*>(ptr), 'A', 1024 * 1024 * 4);
+  }
+}
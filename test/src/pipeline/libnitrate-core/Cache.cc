@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <unistd.h>
 
+#include <filesystem>
 #include <nitrate-core/Cache.hh>
 #include <nitrate-core/Init.hh>
 
@@ -72,3 +74,42 @@ TEST(Core, Cache_Read) {
     EXPECT_EQ(value, VALUE_B);
   }
 }
+
+TEST(Core, Cache_FileSystem) {
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    const auto root = std::filesystem::temp_directory_path() / ("ncc-cache-test-" + std::to_string(::getpid()));
+    ncc::FileSystemResourceCache cache(root);
+
+    EXPECT_FALSE(cache.Has(KEY_A));
+    EXPECT_TRUE(cache.Write(KEY_A, VALUE_A));
+    EXPECT_TRUE(cache.Has(KEY_A));
+    EXPECT_FALSE(cache.Has(KEY_B));
+
+    std::string value;
+    EXPECT_TRUE(cache.Read(KEY_A, value));
+    EXPECT_EQ(value, VALUE_A);
+    EXPECT_FALSE(cache.Read(KEY_B, value));
+
+    EXPECT_TRUE(cache.Write(KEY_A, VALUE_B));
+    EXPECT_TRUE(cache.Read(KEY_A, value));
+    EXPECT_EQ(value, VALUE_B);
+
+    std::filesystem::remove_all(root);
+  }
+}
+
+TEST(Core, Cache_Unbind) {
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    Cache.clear();
+    ncc::GetCache().Bind(HasImpl, ReadImpl, WriteImpl);
+    EXPECT_TRUE(ncc::GetCache().IsBound());
+
+    ncc::GetCache().Unbind();
+    EXPECT_FALSE(ncc::GetCache().IsBound());
+    EXPECT_FALSE(ncc::GetCache().Write(KEY_A, VALUE_A));
+    EXPECT_FALSE(Cache.contains(KEY_A));
+
+    std::string value;
+    EXPECT_FALSE(ncc::GetCache().Read(KEY_A, value));
+  }
+}
@@ -3,6 +3,8 @@
 #include <nitrate-core/Init.hh>
 #include <nitrate-core/SmartLock.hh>
 #include <nitrate-core/String.hh>
+#include <thread>
+#include <vector>
 
 // Some not-empty string content.
 static const char* StringContent = "Hello, World!";
@@ -140,3 +142,75 @@ TEST(Core, String_Sync_Compare) {
 
   ncc::EnableSync = old;
 }
+
+TEST(Core, String_Dedup_Hash) {
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    ncc::string a = std::string(StringContent);
+    ncc::string b = std::string_view(StringContent);
+
+    EXPECT_EQ(&a.Get(), &b.Get());
+    EXPECT_EQ(a.Hash(), std::hash<std::string_view>{}(StringContent));
+    EXPECT_EQ(std::hash<ncc::string>{}(a), std::hash<ncc::string>{}(b));
+    EXPECT_EQ(ncc::string().Hash(), ncc::string("").Hash());
+  }
+}
+
+TEST(Core, String_Sync_Intern_Concurrent) {
+  bool old = ncc::EnableSync;
+  ncc::EnableSync = true;
+
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    constexpr auto kThreads = 8;
+    constexpr auto kCount = 1'000;
+
+    std::vector<std::vector<ncc::string>> results(kThreads);
+    std::vector<std::thread> threads;
+
+    for (auto t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&results, t]() {
+        for (auto i = 0; i < kCount; ++i) {
+          results[t].emplace_back(HexEncode(i));
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (auto t = 1; t < kThreads; ++t) {
+      for (auto i = 0; i < kCount; ++i) {
+        EXPECT_EQ(&results[0][i].Get(), &results[t][i].Get());
+      }
+    }
+  }
+
+  ncc::EnableSync = old;
+}
+
+TEST(Core, String_Pool_Scope) {
+  if (auto lib_rc = ncc::CoreLibrary.GetRC()) {
+    ncc::string global = StringContent;
+    ncc::StringPool pool;
+
+    {
+      ncc::StringScope scope(pool);
+
+      ncc::string a = StringContent;
+      ncc::string b = std::string(StringContent);
+
+      EXPECT_EQ(&a.Get(), &b.Get());
+      EXPECT_NE(&a.Get(), &global.Get());
+      EXPECT_EQ(a, global);
+      EXPECT_EQ(a.Hash(), global.Hash());
+      EXPECT_EQ(pool.GetCount(), 1);
+    }
+
+    ncc::string c = StringContent;
+    EXPECT_EQ(&c.Get(), &global.Get());
+
+    pool.Reset();
+    EXPECT_EQ(pool.GetCount(), 0);
+    EXPECT_EQ(pool.GetGeneration(), 1);
+  }
+}
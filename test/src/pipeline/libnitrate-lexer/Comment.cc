@@ -47,3 +47,4 @@ TEST_CASE(Comment, MultiLine, 4, "/*/*/*/*/**/*//**//**/*/*/*/", {Token(Note, "/
 TEST_CASE(Comment, MultiLine, 5, "/* hehe 🔥🍉*/", {Token(Note, " hehe 🔥🍉")})
 TEST_CASE(Comment, MultiLine, 6, "/*\xed\xa0\x80\xed*/", {Token(Note, "\xed\xa0\x80\xed")})
 TEST_CASE(Comment, MultiLine, 7, "/* //foo// * */", {Token(Note, " //foo// * ")})
+TEST_CASE(Comment, MultiLine, 8, "abc /* never closed", {Token("abc")})
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Init.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <pipeline/libnitrate-lexer/LexicalCase.hh>
+
+using namespace ncc;
+using namespace ncc::lex;
+
+static constexpr std::string_view kSample =
+    "fn main(): i32 {\n"
+    "  let s = \"hello\" \"world\", t = \"a\\tb\", c = 'x';\n"
+    "  ~> single line comment\n"
+    "  /* multi\n line */ ret 0x10 + 3.14;\n"
+    "}\n";
+
+TEST(Lexer, ContiguousSource_MatchesStream) {
+  if (auto lib_rc = LexerLibrary.GetRC()) {
+    auto streamed = LexString(kSample);
+
+    Tokenizer tokenizer(kSample, std::make_shared<Environment>());
+    std::vector<Token> tokens;
+    while (auto token = tokenizer.Next()) {
+      tokens.push_back(token);
+    }
+
+    ASSERT_EQ(streamed.first, tokens);
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+      auto expected = streamed.first[i].GetStart().Get(streamed.second);
+      auto actual = tokens[i].GetStart().Get(tokenizer);
+
+      EXPECT_EQ(expected.GetRow(), actual.GetRow());
+      EXPECT_EQ(expected.GetCol(), actual.GetCol());
+      EXPECT_EQ(expected.GetOffset(), actual.GetOffset());
+    }
+  }
+}
+
+TEST(Lexer, ContiguousSource_SourceWindow) {
+  if (auto lib_rc = LexerLibrary.GetRC()) {
+    Tokenizer tokenizer(kSample, std::make_shared<Environment>());
+
+    auto window = tokenizer.GetSourceWindow({0, 0}, {0, 7});
+    ASSERT_TRUE(window.has_value());
+    ASSERT_EQ(window->size(), 1);
+    EXPECT_EQ(window->at(0), "fn main");
+  }
+}
@@ -70,6 +70,10 @@ TEST_CASE(Float, Valid, 41, "1.234e4.53.",
                  "36886757759430575696106796085125386386957287149695585909212064143149828937551992348582163146963908369"
                  "9737879276"),
            OpDot});
+TEST_CASE(Float, Valid, 42, "0.5e-1", {Token(NumL, "0.05")});
+TEST_CASE(Float, Valid, 43, "00.0e5", {Token(NumL, "0.0")});
+TEST_CASE(Float, Valid, 44, "1.250e+2", {Token(NumL, "125.0")});
+TEST_CASE(Float, Valid, 45, "12345e-5", {Token(NumL, "0.12345")});
 
 ///=============================================================================
 /// INVALID FLOATS
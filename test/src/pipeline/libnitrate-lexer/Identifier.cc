@@ -15,6 +15,8 @@ TEST_CASE(Identifier, ASCII, 5, " abc+def ", {Token("abc"), Token(OpPlus), Token
 TEST_CASE(Identifier, ASCII, 6, " 123i32 ", {Token(123UL), Token("i32")});
 TEST_CASE(Identifier, ASCII, 7, " 123.2i32 ", {Token(NumL, "123.2"), Token("i32")});
 TEST_CASE(Identifier, ASCII, 8, " 123.6i32/1 ", {Token(NumL, "123.6"), Token("i32"), Token(OpSlash), Token(1UL)});
+TEST_CASE(Identifier, ASCII, 9, "  \t\n\r\v\f  \n\n   \t\t\t     \n\n  \t  abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789 x",
+          {Token("abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789"), Token("x")});
 
 ///============================================================================///
 /// UNICODE IDENTIFIERS
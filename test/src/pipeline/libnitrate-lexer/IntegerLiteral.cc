@@ -108,6 +108,9 @@ TEST_CASE(Integer, Dec, 97, "140695_152_6", {1406951526})
 TEST_CASE(Integer, Dec, 98, "130201_609_9", {1302016099})
 TEST_CASE(Integer, Dec, 99, "123064_674_0", {1230646740})
 TEST_CASE(Integer, Dec, 100, "114249_191_\n7", {1142491917})
+TEST_CASE(Integer, Dec, 101, "0007", {7})
+TEST_CASE(Integer, Dec, 102, "9999999999999999999", {Token(IntL, "9999999999999999999")})
+TEST_CASE(Integer, Dec, 103, "18446744073709551616", {Token(IntL, "18446744073709551616")})
 
 ///=============================================================================
 /// EXPLICIT DECIMAL LITERALS
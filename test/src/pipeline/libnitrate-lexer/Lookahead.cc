@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Init.hh>
+#include <nitrate-lexer/Lexer.hh>
+
+using namespace ncc;
+using namespace ncc::lex;
+
+TEST(Lexer, Lookahead_PeekN) {
+  if (auto lib_rc = LexerLibrary.GetRC()) {
+    Tokenizer tokenizer("a b c", std::make_shared<Environment>());
+
+    EXPECT_EQ(tokenizer.Peek(2), Token(Name, "c"));
+    EXPECT_EQ(tokenizer.Peek(1), Token(Name, "b"));
+    EXPECT_EQ(tokenizer.Peek(3), Token::EndOfFile());
+    EXPECT_EQ(tokenizer.Peek(100), Token::EndOfFile());
+    EXPECT_FALSE(tokenizer.IsEof());
+
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "a"));
+    EXPECT_EQ(tokenizer.Peek(0), Token(Name, "b"));
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "b"));
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "c"));
+    EXPECT_EQ(tokenizer.Next(), Token::EndOfFile());
+  }
+}
+
+TEST(Lexer, Lookahead_SkipsComments) {
+  if (auto lib_rc = LexerLibrary.GetRC()) {
+    Tokenizer tokenizer("a /* x */ b # y\n c", std::make_shared<Environment>());
+    tokenizer.SkipCommentsState(true);
+
+    EXPECT_EQ(tokenizer.Peek(2), Token(Name, "c"));
+    EXPECT_TRUE(tokenizer.CommentBuffer().empty());
+
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "a"));
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "b"));
+    EXPECT_EQ(tokenizer.CommentBuffer().size(), 1);
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "c"));
+    EXPECT_EQ(tokenizer.CommentBuffer().size(), 2);
+  }
+}
+
+TEST(Lexer, Lookahead_Insert) {
+  if (auto lib_rc = LexerLibrary.GetRC()) {
+    Tokenizer tokenizer("a", std::make_shared<Environment>());
+
+    for (int i = 0; i < 40; i++) {
+      tokenizer.Insert(Token(Oper, OpPlus));
+    }
+
+    EXPECT_EQ(tokenizer.Peek(40), Token(Name, "a"));
+    for (int i = 0; i < 40; i++) {
+      EXPECT_EQ(tokenizer.Next(), Token(Oper, OpPlus));
+    }
+    EXPECT_EQ(tokenizer.Next(), Token(Name, "a"));
+  }
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <ScanKernels.hh>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace ncc::lex::detail;
+
+namespace {
+  constexpr std::array kLengths = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65};
+
+  using Buffer = std::vector<uint8_t>;
+
+  /* Each entry is a search kernel and a byte that continues its run */
+  struct SearchCase {
+    const char *m_name;
+    ScanKernels::Search ScanKernels::*m_search;
+    uint8_t m_filler;
+  };
+
+  constexpr std::array kSearches = {
+      SearchCase{"skip_whitespace", &ScanKernels::m_skip_whitespace, ' '},
+      SearchCase{"find_identifier_end", &ScanKernels::m_find_identifier_end, 'a'},
+      SearchCase{"find_dquote_or_escape", &ScanKernels::m_find_dquote_or_escape, 'a'},
+      SearchCase{"find_squote_or_escape", &ScanKernels::m_find_squote_or_escape, 'a'},
+  };
+
+  /* Compare every supported kernel set against the scalar reference on `buf`.
+   * The buffer is sized exactly, so an overread is visible to sanitizers. */
+  void ExpectSameAsScalar(const Buffer &buf, const char *what) {
+    const auto kernels = GetSupportedScanKernels();
+    const auto &scalar = *kernels.front();
+    const auto *begin = buf.data();
+    const auto *end = buf.data() + buf.size();
+
+    for (const auto *kernel : kernels) {
+      for (const auto &search : kSearches) {
+        EXPECT_EQ((kernel->*search.m_search)(begin, end) - begin, (scalar.*search.m_search)(begin, end) - begin)
+            << kernel->m_name << " " << search.m_name << " on " << what << " of length " << buf.size();
+      }
+
+      EXPECT_EQ(kernel->m_count_newlines(begin, end), scalar.m_count_newlines(begin, end))
+          << kernel->m_name << " count_newlines on " << what << " of length " << buf.size();
+    }
+  }
+}  // namespace
+
+TEST(Lexer, ScanKernels_ScalarIsFirst) {
+  const auto kernels = GetSupportedScanKernels();
+
+  ASSERT_FALSE(kernels.empty());
+  EXPECT_EQ(kernels.front()->m_name, "scalar");
+  EXPECT_NE(std::find(kernels.begin(), kernels.end(), &GetScanKernels()), kernels.end());
+}
+
+TEST(Lexer, ScanKernels_EveryByteAtEveryPosition) {
+  const auto kernels = GetSupportedScanKernels();
+  const auto &scalar = *kernels.front();
+
+  for (const auto len : kLengths) {
+    for (const auto &search : kSearches) {
+      for (int byte = 0; byte <= 0xff; byte++) {
+        for (int pos = 0; pos < len; pos++) {
+          Buffer buf(len, search.m_filler);
+          buf[pos] = static_cast<uint8_t>(byte);
+
+          const auto *begin = buf.data();
+          const auto *end = buf.data() + buf.size();
+          const auto expected = (scalar.*search.m_search)(begin, end) - begin;
+
+          for (const auto *kernel : kernels) {
+            ASSERT_EQ((kernel->*search.m_search)(begin, end) - begin, expected)
+                << kernel->m_name << " " << search.m_name << " with byte " << byte << " at " << pos << " of " << len;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(Lexer, ScanKernels_MatchInLastByte) {
+  for (const auto len : kLengths) {
+    if (len == 0) {
+      continue;
+    }
+
+    for (const uint8_t last : {'x', '"', '\'', '\\', '\n', '\0', '\xff', '!'}) {
+      Buffer ws(len, ' ');
+      ws.back() = last;
+      ExpectSameAsScalar(ws, "whitespace run");
+
+      Buffer ident(len, 'a');
+      ident.back() = last;
+      ExpectSameAsScalar(ident, "identifier run");
+    }
+  }
+}
+
+TEST(Lexer, ScanKernels_EmbeddedNulAndFF) {
+  for (const auto len : kLengths) {
+    for (int pos = 0; pos < len; pos++) {
+      for (const uint8_t embedded : {0x00, 0xff}) {
+        Buffer ws(len, '\t');
+        ws[pos] = embedded;
+        ExpectSameAsScalar(ws, "whitespace run");
+
+        Buffer ident(len, 'Z');
+        ident[pos] = embedded;
+        ExpectSameAsScalar(ident, "identifier run");
+
+        Buffer lines(len, '\n');
+        lines[pos] = embedded;
+        ExpectSameAsScalar(lines, "newline run");
+      }
+    }
+  }
+}
+
+TEST(Lexer, ScanKernels_AllBytesAtEveryOffset) {
+  Buffer all(0x100);
+  for (size_t i = 0; i < all.size(); i++) {
+    all[i] = static_cast<uint8_t>(i);
+  }
+
+  for (size_t offset = 0; offset < all.size(); offset++) {
+    for (const auto len : kLengths) {
+      if (offset + len > all.size()) {
+        continue;
+      }
+
+      ExpectSameAsScalar(Buffer(all.begin() + offset, all.begin() + offset + len), "byte sequence");
+    }
+  }
+}
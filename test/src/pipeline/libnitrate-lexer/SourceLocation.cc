@@ -18,4 +18,7 @@ using namespace ncc::lex;
     }                                                                              \
   }
 
-/// TODO: Test cases for source location
+SOURCE_LOCATION_TEST(0, "abc", 0, 1, 1)
+SOURCE_LOCATION_TEST(1, " abc", 0, 2, 2)
+SOURCE_LOCATION_TEST(2, "\n\n  abc", 2, 3, 5)
+SOURCE_LOCATION_TEST(3, "\t\n\"x\"", 1, 1, 3)
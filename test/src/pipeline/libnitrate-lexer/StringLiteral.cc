@@ -21,3 +21,4 @@ TEST_CASE(String, Sym, 9, R"('🔥 🍉')", {Token(Text, "🔥 🍉")});
 TEST_CASE(String, Sym, 10, "'\x4e\xe0\x10\x1b\x19\xa4\x36\x47\x2c\x07'",
           {Token(Text, "\x4e\xe0\x10\x1b\x19\xa4\x36\x47\x2c\x07")});
 TEST_CASE(String, Sym, 11, "\"abc\x45\x89\xd0\"", {Token(Text, "abc\x45\x89\xd0")});
+TEST_CASE(String, Sym, 12, "abc \"never closed", {Token("abc")});
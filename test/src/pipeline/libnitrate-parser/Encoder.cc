@@ -7,6 +7,7 @@
 #include <nitrate-parser/ASTWriter.hh>
 #include <nitrate-parser/Context.hh>
 #include <nitrate-parser/Init.hh>
+#include <sstream>
 #include <static-data/SourceSample_01.hh>
 
 using namespace ncc::parse;
@@ -26,3 +27,40 @@ TEST(AST, Encoder) {
     EXPECT_TRUE(serialized.size() > 100);
   }
 }
+
+TEST(AST, StreamingEncoder) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto env = std::make_shared<ncc::Environment>();
+    auto original = GeneralParser::ParseString<ncc::lex::Tokenizer>(test::vector::SOURCE_SAMPLE_01, env, my_pool);
+    EXPECT_TRUE(original.Check());
+
+    std::stringstream stream;
+    original.Get()->Serialize(stream);
+
+    auto buffered = AstReader(stream.str(), my_pool, std::nullopt).Get();
+    ASSERT_TRUE(buffered.has_value());
+    EXPECT_TRUE(original.Get()->IsEq(buffered.value()));
+
+    auto streamed = AstReader(stream, my_pool, std::nullopt).Get();
+    ASSERT_TRUE(streamed.has_value());
+    EXPECT_TRUE(original.Get()->IsEq(streamed.value()));
+  }
+}
+
+TEST(AST, StreamingDecoderNonBlock) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto env = std::make_shared<ncc::Environment>();
+    auto original = GeneralParser::ParseString<ncc::lex::Tokenizer>("fn main(): i32 { ret 0; }", env, my_pool);
+    EXPECT_TRUE(original.Check());
+
+    const auto &statements = original.Get()->As<Block>()->GetStatements();
+    ASSERT_EQ(statements.size(), 1);
+
+    std::istringstream stream(statements.front()->Serialize());
+    auto decoded = AstReader(stream, my_pool, std::nullopt).Get();
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_TRUE(statements.front()->IsEq(decoded.value()));
+  }
+}
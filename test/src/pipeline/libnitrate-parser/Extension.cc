@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTExpr.hh>
+#include <nitrate-parser/ASTFactory.hh>
+#include <nitrate-parser/Init.hh>
+
+using namespace ncc::parse;
+
+TEST(AST, Extension_AllocatedFromScope) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto node = ASTFactory(my_pool).CreateNull();
+
+    {
+      ASTExtensionScope scope(my_pool);
+      const auto used = my_pool.GetSpaceUsed();
+
+      node->SetLoc(ncc::lex::LocationID(1), ncc::lex::LocationID(2));
+      EXPECT_GT(my_pool.GetSpaceUsed(), used);
+
+      std::array comments = {ncc::string("a"), ncc::string("b")};
+      node->SetComments(comments);
+    }
+
+    EXPECT_EQ(node->Begin(), ncc::lex::LocationID(1));
+    EXPECT_EQ(node->End(), ncc::lex::LocationID(2));
+    ASSERT_EQ(node->Comments().size(), 2);
+    EXPECT_EQ(node->Comments()[0], ncc::string("a"));
+    EXPECT_EQ(node->Comments()[1], ncc::string("b"));
+  }
+}
+
+TEST(AST, Extension_EmptyLocationIsFree) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto node = ASTFactory(my_pool).CreateNull();
+
+    ASTExtensionScope scope(my_pool);
+    const auto used = my_pool.GetSpaceUsed();
+
+    node->SetLoc(ncc::lex::LocationID(), ncc::lex::LocationID());
+    EXPECT_EQ(my_pool.GetSpaceUsed(), used);
+    EXPECT_EQ(node->Begin(), ncc::lex::LocationID());
+    EXPECT_TRUE(node->Comments().empty());
+  }
+}
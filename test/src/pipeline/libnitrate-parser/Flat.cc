@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTFlat.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <sstream>
+#include <static-data/SourceSample_01.hh>
+#include <vector>
+
+using namespace ncc::parse;
+
+static auto EncodeFlat(const ncc::FlowPtr<Expr> &root) -> std::string {
+  std::stringstream ss;
+  FlatAstWriter(ss).Write(root);
+  return ss.str();
+}
+
+TEST(AST, Flat_RoundTrip) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto env = std::make_shared<ncc::Environment>();
+    auto original = GeneralParser::ParseString<ncc::lex::Tokenizer>(test::vector::SOURCE_SAMPLE_01, env, my_pool);
+    EXPECT_TRUE(original.Check());
+
+    auto encoded = EncodeFlat(original.Get());
+    auto decoded = FlatAstReader(encoded, my_pool).Get();
+    ASSERT_TRUE(decoded.has_value());
+
+    EXPECT_TRUE(original.Get()->IsEq(decoded.value()));
+    EXPECT_EQ(EncodeFlat(decoded.value()), encoded);
+  }
+}
+
+TEST(AST, Flat_TraverseInPlace) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto env = std::make_shared<ncc::Environment>();
+    auto original = GeneralParser::ParseString<ncc::lex::Tokenizer>(test::vector::SOURCE_SAMPLE_01, env, my_pool);
+    EXPECT_TRUE(original.Check());
+
+    auto encoded = EncodeFlat(original.Get());
+    auto ast = FlatAst::Open(encoded);
+    ASSERT_TRUE(ast.has_value());
+    EXPECT_EQ(ast->Root().GetKind(), original.Get()->GetKind());
+
+    size_t records = 0;
+    for (uint32_t offset = 0; offset < ast->NodesSize(); offset += ast->At(offset).GetSize() * 4) {
+      records++;
+    }
+
+    size_t reachable = 0;
+    std::vector<FlatNode> stack = {ast->Root()};
+    while (!stack.empty()) {
+      auto node = stack.back();
+      stack.pop_back();
+      reachable++;
+
+      node.ForEachChild([&](FlatNode child) {
+        EXPECT_LT(child.GetOffset(), node.GetOffset());
+        stack.push_back(child);
+      });
+    }
+
+    EXPECT_GT(records, 100);
+    EXPECT_EQ(reachable, records);
+  }
+}
+
+TEST(AST, Flat_RejectsCorruptInput) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto env = std::make_shared<ncc::Environment>();
+    auto original = GeneralParser::ParseString<ncc::lex::Tokenizer>("let x = 1 + 2;", env, my_pool);
+    EXPECT_TRUE(original.Check());
+
+    auto encoded = EncodeFlat(original.Get());
+    ASSERT_TRUE(FlatAst::Open(encoded).has_value());
+
+    auto truncated = encoded.substr(0, encoded.size() - 1);
+    EXPECT_FALSE(FlatAst::Open(truncated).has_value());
+    EXPECT_FALSE(FlatAstReader(truncated, my_pool).Get().has_value());
+
+    auto bad_magic = encoded;
+    bad_magic[0] = 'X';
+    EXPECT_FALSE(FlatAst::Open(bad_magic).has_value());
+
+    /* The root must be the start of a record */
+    auto bad_root = encoded;
+    uint32_t root = 4;
+    std::memcpy(bad_root.data() + offsetof(flat::Header, m_root), &root, sizeof(root));
+    EXPECT_FALSE(FlatAst::Open(bad_root).has_value());
+  }
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Allocate.hh>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTStmt.hh>
+#include <nitrate-parser/Algorithm.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <vector>
+
+using namespace ncc::parse;
+
+static constexpr std::string_view kSource = R"(
+fn add(a: i32, b: i32): i32 {
+  // Comments inside deferred bodies are kept
+  let sum = a + b;
+  if sum > 10 { ret sum; }
+  ret sum - 1;
+}
+
+let x = add(1, 2), y = [1, 2, (3 + 4)];
+let z: i32 = fn (v: i32): i32 { ret v * 2; }(x);
+fn twice(v: i32): i32 => v * 2;
+)";
+
+static auto CollectDeferred(GeneralParser &parser, const ncc::FlowPtr<Expr> &root) {
+  std::vector<ncc::FlowPtr<Expr>> nodes;
+  for_each(root, [&](const auto &node) {
+    if (parser.IsDeferred(node)) {
+      nodes.push_back(node);
+    }
+  });
+
+  return nodes;
+}
+
+TEST(AST, Lazy_MaterializeMatchesEager) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto env = std::make_shared<ncc::Environment>();
+    auto pool = ncc::DynamicArena();
+
+    ncc::lex::Tokenizer eager_tokenizer(kSource, env);
+    auto eager = GeneralParser(eager_tokenizer, env, pool).Parse();
+    ASSERT_TRUE(eager.Check());
+
+    ncc::lex::Tokenizer lazy_tokenizer(kSource, env);
+    auto parser = GeneralParser(lazy_tokenizer, env, pool);
+    parser.SetLazyBodies(true);
+
+    auto lazy = parser.Parse();
+    ASSERT_TRUE(lazy.Check());
+
+    auto deferred = CollectDeferred(parser, lazy.Get());
+    EXPECT_EQ(deferred.size(), 4);
+    EXPECT_FALSE(eager.Get()->IsEq(lazy.Get()));
+
+    for (const auto &node : deferred) {
+      EXPECT_TRUE(parser.Materialize(node));
+      EXPECT_FALSE(parser.IsDeferred(node));
+    }
+
+    EXPECT_FALSE(parser.Materialize(deferred.front()));
+    EXPECT_TRUE(eager.Get()->IsEq(lazy.Get()));
+  }
+}
+
+TEST(AST, Lazy_AmbiguousInitializerIsParsed) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto env = std::make_shared<ncc::Environment>();
+    auto pool = ncc::DynamicArena();
+
+    ncc::lex::Tokenizer tokenizer("let a = x as Map<i32, u8>, b = 2;", env);
+    auto parser = GeneralParser(tokenizer, env, pool);
+    parser.SetLazyBodies(true);
+
+    auto root = parser.Parse();
+    ASSERT_TRUE(root.Check());
+
+    size_t parsed = 0;
+    size_t deferred = 0;
+    for_each<Variable>(root.Get(), [&](const auto &var) {
+      parsed += var->GetInitializer().has_value() ? 1 : 0;
+      deferred += parser.IsDeferred(var) ? 1 : 0;
+    });
+
+    EXPECT_EQ(parsed, 1);
+    EXPECT_EQ(deferred, 1);
+  }
+}
+
+TEST(AST, Lazy_ErrorsSurfaceOnMaterialize) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto env = std::make_shared<ncc::Environment>();
+    auto pool = ncc::DynamicArena();
+
+    ncc::lex::Tokenizer tokenizer("fn f() { let = ; }", env);
+    auto parser = GeneralParser(tokenizer, env, pool);
+    parser.SetLazyBodies(true);
+
+    auto root = parser.Parse();
+    ASSERT_TRUE(root.Check());
+
+    auto deferred = CollectDeferred(parser, root.Get());
+    ASSERT_EQ(deferred.size(), 1);
+    EXPECT_FALSE(parser.Materialize(deferred.front()));
+  }
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Allocate.hh>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <string>
+
+using namespace ncc::parse;
+
+static auto GenerateSource(size_t functions) -> std::string {
+  std::string source;
+
+  for (size_t i = 0; i < functions; ++i) {
+    const auto id = std::to_string(i);
+    source += "// function " + id + "\n";
+    source += "fn f" + id + "(x: i32): i32 {\n";
+    source += "  if x > " + id + " { ret x - 1; } else { ret x + " + id + "; }\n";
+    source += "}\n";
+    source += "let v" + id + " = f" + id + "(" + id + ");\n";
+  }
+
+  return source;
+}
+
+static auto ParseSequential(std::string_view source, ncc::DynamicArena &pool) {
+  auto env = std::make_shared<ncc::Environment>();
+  ncc::lex::Tokenizer tokenizer(source, env);
+
+  return GeneralParser::Create(tokenizer, env, pool)->Parse();
+}
+
+static auto ParseParallel(std::string_view source, ncc::DynamicArena &pool, size_t jobs) {
+  auto env = std::make_shared<ncc::Environment>();
+  ncc::lex::Tokenizer tokenizer(source, env);
+
+  return GeneralParser::ParseParallel(tokenizer, env, pool, jobs);
+}
+
+TEST(AST, Parallel_MatchesSequential) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    const auto source = GenerateSource(2000);
+
+    auto seq_pool = ncc::DynamicArena();
+    auto par_pool = ncc::DynamicArena(ncc::ArenaSync::PerThread);
+    auto expected = ParseSequential(source, seq_pool);
+    auto actual = ParseParallel(source, par_pool, 4);
+
+    ASSERT_TRUE(expected.Check());
+    ASSERT_TRUE(actual.Check());
+    EXPECT_TRUE(expected.Get()->IsEq(actual.Get()));
+    EXPECT_EQ(expected.Get()->Begin(), actual.Get()->Begin());
+  }
+}
+
+TEST(AST, Parallel_ReportsSyntaxErrors) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto source = GenerateSource(1000);
+    source.insert(source.size() / 2, "\nfn broken( {\n}\n");
+
+    auto pool = ncc::DynamicArena(ncc::ArenaSync::PerThread);
+    EXPECT_FALSE(ParseParallel(source, pool, 4).Check());
+  }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <static-data/SourceSample_01.hh>
+
+using namespace ncc::parse;
+
+static auto Parse(std::string_view source, ncc::DynamicArena &pool) {
+  auto env = std::make_shared<ncc::Environment>();
+  auto ast = GeneralParser::ParseString<ncc::lex::Tokenizer>(source, env, pool);
+  EXPECT_TRUE(ast.Check());
+
+  return ast.Get();
+}
+
+TEST(AST, Structural_IgnoresLayout) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto a = Parse("if x { ret x + 1; }", my_pool);
+    auto b = Parse("if x {\n  /* comment */\n  ret x+1;\n}", my_pool);
+
+    EXPECT_TRUE(a->IsEq(b));
+    EXPECT_EQ(a->Hash64(), b->Hash64());
+  }
+}
+
+TEST(AST, Structural_DetectsDifference) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto a = Parse("if x { ret x + 1; }", my_pool);
+
+    for (const auto *source : {"if x { ret x - 1; }", "if y { ret x + 1; }", "if x { ret x + 2; }",
+                               "if x { ret x + 1; ret; }", "if x { ret x + 1; } else { ret; }"}) {
+      auto b = Parse(source, my_pool);
+
+      EXPECT_FALSE(a->IsEq(b)) << source;
+      EXPECT_NE(a->Hash64(), b->Hash64()) << source;
+    }
+  }
+}
+
+TEST(AST, Structural_LargeSample) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto a = Parse(test::vector::SOURCE_SAMPLE_01, my_pool);
+    auto b = Parse(test::vector::SOURCE_SAMPLE_01, my_pool);
+
+    EXPECT_NE(a.get(), b.get());
+    EXPECT_TRUE(a->IsEq(b));
+    EXPECT_EQ(a->Hash64(), b->Hash64());
+  }
+}
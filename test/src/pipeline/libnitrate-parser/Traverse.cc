@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <nitrate-core/Environment.hh>
+#include <nitrate-lexer/Lexer.hh>
+#include <nitrate-parser/ASTBase.hh>
+#include <nitrate-parser/ASTStmt.hh>
+#include <nitrate-parser/Algorithm.hh>
+#include <nitrate-parser/Context.hh>
+#include <nitrate-parser/Init.hh>
+#include <vector>
+
+using namespace ncc::parse;
+
+static constexpr std::string_view kSource =
+    "fn f(x: i32): i32 { ret x + 1; }\n"
+    "fn g(): i32 { let y = f(2); ret y * 3; }\n";
+
+static auto Parse(std::string_view source, ncc::DynamicArena &pool) {
+  auto env = std::make_shared<ncc::Environment>();
+  auto ast = GeneralParser::ParseString<ncc::lex::Tokenizer>(source, env, pool);
+  EXPECT_TRUE(ast.Check());
+
+  return ast.Get();
+}
+
+TEST(AST, Traverse_Orders) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto root = Parse(kSource, my_pool);
+
+    std::vector<Expr *> pre;
+    std::vector<Expr *> post;
+    std::vector<Expr *> bfs;
+
+    for_each(root, [&](auto node) { pre.push_back(node.get()); });
+    iterate<dfs_post>(root, [&](auto, auto node) {
+      post.push_back(node.get());
+      return IterOp::Proceed;
+    });
+    iterate<bfs_pre>(root, [&](auto, auto node) {
+      bfs.push_back(node.get());
+      return IterOp::Proceed;
+    });
+
+    ASSERT_FALSE(pre.empty());
+    EXPECT_EQ(pre.size(), root->RecursiveChildCount());
+    EXPECT_EQ(pre.size(), post.size());
+    EXPECT_EQ(pre.size(), bfs.size());
+    EXPECT_EQ(pre.front(), root.get());
+    EXPECT_EQ(post.back(), root.get());
+    EXPECT_EQ(bfs.front(), root.get());
+  }
+}
+
+TEST(AST, Traverse_TypedAndPruned) {
+  if (auto lib_rc = ncc::parse::ParseLibrary.GetRC()) {
+    auto my_pool = ncc::DynamicArena();
+    auto root = Parse(kSource, my_pool);
+
+    size_t functions = 0;
+    size_t returns = 0;
+    for_each<Function>(root, [&](auto) { functions++; });
+    for_each<Return>(root, [&](auto) { returns++; });
+
+    EXPECT_EQ(functions, 2);
+    EXPECT_EQ(returns, 2);
+
+    size_t visited = 0;
+    for_each(root, [&](auto node) {
+      visited++;
+      return node->template Is<Function>() ? IterOp::SkipChildren : IterOp::Proceed;
+    });
+
+    size_t total = 0;
+    for_each(root, [&](auto) { total++; });
+    EXPECT_LT(visited, total);
+
+    size_t until_abort = 0;
+    for_each(root, [&](auto) { return ++until_abort == 3 ? IterOp::Abort : IterOp::Proceed; });
+    EXPECT_EQ(until_abort, 3);
+  }
+}
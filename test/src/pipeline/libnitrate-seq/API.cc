@@ -1,7 +1,173 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-seq/Init.hh>
 #include <nitrate-seq/Sequencer.hh>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+using namespace ncc;
+using namespace ncc::lex;
+using namespace ncc::seq;
 
 TEST(Sequencer, GetTime) {
   //
-}
\ No newline at end of file
+}
+
+TEST(Sequencer, Prelude_SharedAcrossInstances) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    for (int i = 0; i < 2; i++) {
+      std::istringstream source("@(return n.enstr('x')) y");
+      Sequencer sequencer(source, std::make_shared<Environment>());
+
+      EXPECT_EQ(sequencer.Next(), Token(Text, "x"));
+      EXPECT_EQ(sequencer.Next(), Token(Name, "y"));
+      EXPECT_EQ(sequencer.Next(), Token::EndOfFile());
+      EXPECT_FALSE(sequencer.HasError());
+    }
+  }
+}
+
+TEST(Sequencer, Macro_CallDiscardsReturnValues) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    std::istringstream source(
+        "@(function f() n.emit('a') return 'x' end) @(function g() return {} end) "
+        "@f @g @f @(return 'b') @(return nil) @(return 'b')");
+    Sequencer sequencer(source, std::make_shared<Environment>());
+
+    EXPECT_EQ(sequencer.Next(), Token(Name, "a"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "a"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "b"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "b"));
+    EXPECT_EQ(sequencer.Next(), Token::EndOfFile());
+    EXPECT_FALSE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Macro_NonStringResult) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    std::istringstream source("@(return {}) a");
+    Sequencer sequencer(source, std::make_shared<Environment>());
+
+    while (sequencer.Next()) {
+    }
+
+    EXPECT_TRUE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Emit_SourceAndTokens) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    std::istringstream source(R"(@(n.emit('a @(return "c") d') n.emit_tok{ty='name', v='b'}) e)");
+    Sequencer sequencer(source, std::make_shared<Environment>());
+
+    EXPECT_EQ(sequencer.Next(), Token(Name, "a"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "c"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "d"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "b"));
+    EXPECT_EQ(sequencer.Next(), Token(Name, "e"));
+    EXPECT_EQ(sequencer.Next(), Token::EndOfFile());
+    EXPECT_FALSE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Emit_RecursionLimit) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    std::istringstream source("@(function f() n.emit('@f x') end) @f");
+    Sequencer sequencer(source, std::make_shared<Environment>());
+
+    while (sequencer.Next()) {
+    }
+
+    EXPECT_TRUE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Profile_InstructionBudget) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    auto env = std::make_shared<Environment>();
+    env->Set("seq.instruction-budget", "100000");
+
+    std::istringstream source("@(while true do end) a");
+    Sequencer sequencer(source, env);
+
+    while (sequencer.Next()) {
+    }
+
+    EXPECT_TRUE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Profile_MacroStatistics) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    std::istringstream source("@(function f() n.emit('a b') end) @f @f");
+    Sequencer sequencer(source, std::make_shared<Environment>());
+
+    while (sequencer.Next()) {
+    }
+
+    const auto profile = nlohmann::json::parse(sequencer.GetProfile());
+    const auto &macros = profile["macros"];
+    const auto f = std::find_if(macros.begin(), macros.end(), [](const auto &m) { return m["name"] == "@f"; });
+
+    ASSERT_NE(f, macros.end());
+    EXPECT_EQ((*f)["calls"], 2);
+    EXPECT_EQ((*f)["tokens"], 4);
+    EXPECT_FALSE(sequencer.HasError());
+  }
+}
+
+TEST(Sequencer, Pool_ResetsGlobalsBetweenJobs) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SequencerPool pool(1);
+
+    {
+      std::istringstream source("@(x = 'a'; string.y = 'b') @(return x .. string.y)");
+      auto sequencer = pool.Create(source, std::make_shared<Environment>());
+
+      EXPECT_EQ(sequencer->Next(), Token(Name, "ab"));
+      EXPECT_EQ(sequencer->Next(), Token::EndOfFile());
+    }
+
+    EXPECT_EQ(pool.GetIdleCount(), 1);
+
+    {
+      std::istringstream source("@(return tostring(x) .. tostring(string.y)) @(return type(comp_if))");
+      auto sequencer = pool.Create(source, std::make_shared<Environment>());
+
+      EXPECT_EQ(pool.GetIdleCount(), 0);
+      EXPECT_EQ(sequencer->Next(), Token(Name, "nilnil"));
+      EXPECT_EQ(sequencer->Next(), Token(Name, "function"));
+      EXPECT_FALSE(sequencer->HasError());
+    }
+  }
+}
+
+TEST(Sequencer, Pool_ResetsStringMetatableBetweenJobs) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SequencerPool pool(1);
+
+    {
+      std::istringstream source(
+          "@(getmetatable('').__index = {}; getmetatable('').x = 'a'; "
+          "setmetatable(string, {__index = function() return 'b' end})) c");
+      auto sequencer = pool.Create(source, std::make_shared<Environment>());
+
+      EXPECT_EQ(sequencer->Next(), Token(Name, "c"));
+      EXPECT_EQ(sequencer->Next(), Token::EndOfFile());
+    }
+
+    {
+      std::istringstream source(
+          "@(return ('ab'):sub(1, 1) .. tostring(getmetatable('').x) .. tostring(string.nope)) "
+          "@(return type(n.env_keys()))");
+      auto sequencer = pool.Create(source, std::make_shared<Environment>());
+
+      EXPECT_EQ(sequencer->Next(), Token(Name, "anilnil"));
+      EXPECT_EQ(sequencer->Next(), Token(Name, "table"));
+      EXPECT_EQ(sequencer->Next(), Token::EndOfFile());
+      EXPECT_FALSE(sequencer->HasError());
+    }
+  }
+}
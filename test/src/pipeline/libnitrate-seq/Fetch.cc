@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <nitrate-seq/Init.hh>
+#include <nitrate-seq/Sequencer.hh>
+#include <string>
+
+using namespace ncc::seq;
+
+namespace {
+  constexpr std::string_view kJobA = "00000000-0000-0000-0000-00000000000a";
+  constexpr std::string_view kJobB = "00000000-0000-0000-0000-00000000000b";
+
+  /* Temporary NCC_SEARCH_PATH that is removed again at the end of a test */
+  class SearchPath {
+    std::filesystem::path m_root;
+
+  public:
+    SearchPath(const char *name) : m_root(std::filesystem::temp_directory_path() / name) {
+      std::filesystem::remove_all(m_root);
+      std::filesystem::create_directories(m_root);
+      setenv("NCC_SEARCH_PATH", m_root.c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+    }
+
+    ~SearchPath() {
+      unsetenv("NCC_SEARCH_PATH");  // NOLINT(concurrency-mt-unsafe)
+      std::filesystem::remove_all(m_root);
+    }
+
+    /* Search a subdirectory of the root instead, which may not exist yet */
+    void Use(const std::string &name) const {
+      setenv("NCC_SEARCH_PATH", (m_root / name).c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+    }
+
+    void Write(const std::string &name, const std::string &content) const {
+      std::filesystem::create_directories((m_root / name).parent_path());
+      std::ofstream(m_root / name) << content;
+    }
+  };
+
+  auto Fetch(std::string_view job, const std::string &name) -> std::optional<std::string> {
+    return FileSystemFetchModule("file:///package/" + std::string(job) + "/" + name);
+  }
+}  // namespace
+
+TEST(Fetch, FindsResourcesInSearchPath) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-find");
+    search_path.Write("a.nit", "a");
+    search_path.Write("sub/b.nit", "b");
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), "a");
+    EXPECT_EQ(Fetch(kJobA, "sub/b.nit"), "b");
+    EXPECT_EQ(Fetch(kJobA, "c.nit"), std::nullopt);
+    EXPECT_EQ(FileSystemFetchModule("file:///package/a.nit"), std::nullopt);
+  }
+}
+
+TEST(Fetch, MissesAreCachedPerJob) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-miss");
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+    search_path.Write("a.nit", "a");
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+    EXPECT_EQ(Fetch(kJobB, "a.nit"), "a");
+  }
+}
+
+TEST(Fetch, InterleavedJobsKeepTheirIndex) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-interleaved");
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+    search_path.Write("a.nit", "a");
+
+    EXPECT_EQ(Fetch(kJobB, "a.nit"), "a");
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+  }
+}
+
+TEST(Fetch, NextJobSeesNewSearchPath) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-new-root");
+    search_path.Use("later");
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+    search_path.Write("later/a.nit", "a");
+    EXPECT_EQ(Fetch(kJobB, "a.nit"), "a");
+  }
+}
+
+#ifdef __linux__
+TEST(Fetch, WatchModeSeesNewSearchPath) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-watch-root");
+    search_path.Use("later/deeper");
+    WatchResourceSearchPaths(true);
+
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), std::nullopt);
+    search_path.Write("later/deeper/a.nit", "a");
+    EXPECT_EQ(Fetch(kJobA, "a.nit"), "a");
+
+    WatchResourceSearchPaths(false);
+  }
+}
+
+TEST(Fetch, WatchModeSeesNewDirectories) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    SearchPath search_path("nitrate-seq-fetch-watch");
+    WatchResourceSearchPaths(true);
+
+    EXPECT_EQ(Fetch(kJobA, "sub/deeper/a.nit"), std::nullopt);
+    EXPECT_EQ(Fetch(kJobB, "sub/deeper/a.nit"), std::nullopt);
+
+    search_path.Write("sub/deeper/a.nit", "a");
+    EXPECT_EQ(Fetch(kJobB, "sub/deeper/a.nit"), "a");
+
+    search_path.Write("sub/deeper/b.nit", "b");
+    EXPECT_EQ(Fetch(kJobB, "sub/deeper/b.nit"), "b");
+
+    WatchResourceSearchPaths(false);
+  }
+}
+#endif
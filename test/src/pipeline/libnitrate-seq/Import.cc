@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <nitrate-core/Cache.hh>
+#include <nitrate-core/Environment.hh>
+#include <nitrate-seq/Init.hh>
+#include <nitrate-seq/Sequencer.hh>
+#include <sstream>
+
+using namespace ncc;
+using namespace ncc::lex;
+using namespace ncc::seq;
+
+namespace {
+  std::map<ResourceKey, std::string> Entries;
+  std::map<std::string, std::string> Modules;
+
+  void BindMemoryCache() {
+    Entries.clear();
+
+    GetCache().Bind([](const ResourceKey &key) { return Entries.contains(key); },
+                    [](const ResourceKey &key, std::string &value) {
+                      if (auto it = Entries.find(key); it != Entries.end()) {
+                        value = it->second;
+                        return true;
+                      }
+
+                      return false;
+                    },
+                    [](const ResourceKey &key, const std::string &value) {
+                      Entries[key] = value;
+                      return true;
+                    });
+  }
+
+  auto Expand(const std::string &code) -> std::vector<Token> {
+    std::istringstream source(code);
+    Sequencer sequencer(source, std::make_shared<Environment>());
+    sequencer.SetFetchFunc([](std::string_view uri) -> std::optional<std::string> {
+      uri.remove_prefix(uri.rfind('/') + 1);
+      if (auto it = Modules.find(std::string(uri)); it != Modules.end()) {
+        return it->second;
+      }
+
+      return std::nullopt;
+    });
+
+    std::vector<Token> tokens;
+    for (auto tok = sequencer.Next(); !tok.Is(EofF); tok = sequencer.Next()) {
+      tokens.push_back(tok);
+    }
+
+    EXPECT_FALSE(sequencer.HasError());
+
+    return tokens;
+  }
+
+  auto Contains(const std::vector<Token> &tokens, const char *name) -> bool {
+    return std::find(tokens.begin(), tokens.end(), Token(Name, name)) != tokens.end();
+  }
+}  // namespace
+
+TEST(Sequencer, Import_CacheChecksDependencies) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    BindMemoryCache();
+    Modules = {{"a", "import b;"}, {"b", "fn one(): i32 { ret 1; }"}};
+
+    EXPECT_TRUE(Contains(Expand("import a;"), "one"));
+    EXPECT_FALSE(Entries.empty());
+
+    Modules["b"] = "fn two(): i32 { ret 2; }";
+
+    const auto tokens = Expand("import a;");
+    EXPECT_TRUE(Contains(tokens, "two"));
+    EXPECT_FALSE(Contains(tokens, "one"));
+
+    GetCache().Unbind();
+  }
+}
+
+TEST(Sequencer, Import_CacheSkipsModulesWithSideEffects) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    BindMemoryCache();
+    Modules = {{"m", "@(x = 'y') fn f(): i32 { ret 0; }"}};
+
+    EXPECT_TRUE(Contains(Expand("import m; @(return tostring(x))"), "y"));
+    EXPECT_TRUE(Contains(Expand("import m; @(return tostring(x))"), "y"));
+    EXPECT_TRUE(Entries.empty());
+
+    GetCache().Unbind();
+  }
+}
+
+TEST(Sequencer, Import_CacheSkipsDeeplyNestedState) {
+  if (auto lib_rc = SeqLibrary.GetRC()) {
+    BindMemoryCache();
+    Modules = {{"m", "fn f(): i32 { ret 0; }"}};
+
+    EXPECT_TRUE(Contains(Expand("@(t = {} for i = 1, 200000 do t = {t} end) import m;"), "f"));
+    EXPECT_TRUE(Entries.empty());
+
+    GetCache().Unbind();
+  }
+}